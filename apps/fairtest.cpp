@@ -0,0 +1,60 @@
+#include "fibre.h"
+
+#include <iostream>
+
+using namespace std;
+
+// local resume fairness: two fibres resume each other on a single worker,
+// while a third fibre, resumed locally before, must still get to run
+static const size_t Rounds = 1000000;
+static const size_t Limit  = 1000;
+
+static FredSemaphore sa(0), sb(0), sc(0);
+static volatile size_t aRound = 0;
+static volatile size_t cRound = 0;
+static volatile bool cDone = false;
+static volatile bool stop = false;
+
+static void fibreA() {
+  sc.V();                             // resume C locally
+  for (size_t r = 0; r < Rounds && !cDone; r += 1) {
+    sb.V();
+    sa.P();
+    aRound = r;
+  }
+  stop = true;
+  sb.V();
+}
+
+static void fibreB() {
+  for (;;) {
+    sb.P();
+    if (stop) return;
+    sa.V();
+  }
+}
+
+static void fibreC() {
+  sc.P();
+  cRound = aRound;
+  cDone = true;
+}
+
+int main() {
+  FibreInit();
+  Fibre* c = new Fibre;
+  c->run(fibreC);
+  Fibre::yield();                     // C blocks
+  Fibre* b = new Fibre;
+  b->run(fibreB);
+  Fibre::yield();                     // B blocks
+  Fibre* a = new Fibre;
+  a->run(fibreA);
+  delete a;
+  delete b;
+  delete c;
+  cout << "C ran after " << cRound << " round trips" << endl;
+  if (cRound >= Limit) abort();
+  cout << "done" << endl;
+  return 0;
+}
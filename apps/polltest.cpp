@@ -0,0 +1,132 @@
+#include "fibre.h"
+
+#include <iostream>
+#include <sys/epoll.h>
+#include <ctime>
+#include <unistd.h>
+
+using namespace std;
+
+static void spin(long ms) { // busy loop without yielding
+  timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  do clock_gettime(CLOCK_MONOTONIC, &t1);
+  while ((t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_nsec - t0.tv_nsec) / 1000000 < ms);
+}
+
+// timeout vs. post: the waiter times out while the only worker is busy, then
+// the poller posts the event before the timed-out waiter has run again
+static int tpipe[2];
+static int tepfd;
+static int tresult = -2;
+
+static void* timeoutWriter(void*) {
+  usleep(5000);
+  char c = 'x';
+  if (write(tpipe[1], &c, 1) != 1) abort();
+  return nullptr;
+}
+
+static void timeoutWaiter() {
+  epoll_event ev;
+  tresult = lfEpollWait(tepfd, &ev, 1, 10);
+}
+
+static void timeoutTest() {
+  SYSCALL(pipe(tpipe));
+  tepfd = SYSCALLIO(epoll_create1(EPOLL_CLOEXEC));
+  epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.fd = tpipe[0];
+  SYSCALL(epoll_ctl(tepfd, EPOLL_CTL_ADD, tpipe[0], &ev));
+  Fibre* f = new Fibre;
+  f->run(timeoutWaiter);
+  Fibre::yield();                     // waiter blocks with timeout
+  pthread_t tid;
+  SYSCALL(pthread_create(&tid, nullptr, timeoutWriter, nullptr));
+  spin(50);
+  delete f;                           // join
+  SYSCALL(pthread_join(tid, nullptr));
+  cout << "timeout vs. post: " << tresult << endl;
+  if (tresult != 0 && tresult != 1) abort();
+  if (lfEpollWait(tepfd, &ev, 1, 0) != 1) abort(); // readiness not lost
+  lfClose(tepfd);
+  lfClose(tpipe[0]);
+  lfClose(tpipe[1]);
+}
+
+// close while re-arm pending: timed epoll waits return (and close the
+// epoll fd) while their re-arm might still be deferred in a busy poller
+static const int Pairs = 8;
+static const int Closers = 32;
+static int ping[Pairs][2];
+static int pong[Pairs][2];
+static volatile bool stop = false;
+
+static void pinger(void* a) {
+  intptr_t i = (intptr_t)a;
+  char c = 'x';
+  while (!stop) {
+    if (lfWrite(ping[i][1], &c, 1) != 1) abort();
+    if (lfRead(pong[i][0], &c, 1) != 1) abort();
+  }
+  c = 'q';
+  if (lfWrite(ping[i][1], &c, 1) != 1) abort();
+}
+
+static void ponger(void* a) {
+  intptr_t i = (intptr_t)a;
+  char c;
+  for (;;) {
+    if (lfRead(ping[i][0], &c, 1) != 1) abort();
+    if (c == 'q') return;
+    if (lfWrite(pong[i][1], &c, 1) != 1) abort();
+  }
+}
+
+static void closer() {
+  for (int n = 0; n < 1000; n += 1) {
+    int p[2];
+    SYSCALL(lfPipe(p));
+    int epfd = SYSCALLIO(epoll_create1(EPOLL_CLOEXEC));
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = p[0];
+    SYSCALL(epoll_ctl(epfd, EPOLL_CTL_ADD, p[0], &ev));
+    lfEpollWait(epfd, &ev, 1, 1);     // register
+    lfEpollWait(epfd, &ev, 1, 1);     // re-arm
+    lfClose(epfd);
+    lfClose(p[0]);
+    lfClose(p[1]);
+  }
+}
+
+static void closeTest() {
+  Context::CurrCluster().addWorkers(3);
+  Fibre* pf[2*Pairs];
+  for (intptr_t i = 0; i < Pairs; i += 1) {
+    SYSCALL(lfPipe(ping[i]));
+    SYSCALL(lfPipe(pong[i]));
+    pf[2*i] = new Fibre;
+    pf[2*i]->run(pinger, (void*)i);
+    pf[2*i+1] = new Fibre;
+    pf[2*i+1]->run(ponger, (void*)i);
+  }
+  Fibre* cf[Closers];
+  for (int i = 0; i < Closers; i += 1) {
+    cf[i] = new Fibre;
+    cf[i]->run(closer);
+  }
+  for (int i = 0; i < Closers; i += 1) delete cf[i];
+  stop = true;
+  for (int i = 0; i < 2*Pairs; i += 1) delete pf[i];
+  cout << "close while re-arm pending: ok" << endl;
+}
+
+int main() {
+  FibreInit();
+  timeoutTest();
+  closeTest();
+  cout << "done" << endl;
+  return 0;
+}
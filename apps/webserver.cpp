@@ -93,9 +93,20 @@ static map<const string,UrlHandler> routingTable;
 // helper mutex for error output
 static shim_mutex_t errOutMtx;
 
+#if defined __LIBFIBRE__
+struct ScopeData {
+  Garage garage;   // parked acceptor_loop fibres
+  FibrePool pool;  // parked connection handler fibres
+};
+
+static ScopeData& CurrScopeData() {
+  return *reinterpret_cast<ScopeData*>(Context::CurrEventScope().getClientData());
+}
+#endif
+
 static Garage& CurrGarage() {
 #if defined __LIBFIBRE__
-  return *reinterpret_cast<Garage*>(Context::CurrEventScope().getClientData());
+  return CurrScopeData().garage;
 #else
   static Garage garage;
   return garage;
@@ -321,6 +332,12 @@ static int create_socket(bool singleAccept = false) {
 }
 #endif
 
+#if defined __LIBFIBRE__
+static void handler(void* arg) {
+  __atomic_add_fetch(&connections, 1, __ATOMIC_RELAXED);
+  while (connHandler(arg));
+}
+#else
 static void handler_loop(void* arg) {
   for (;;) {
     __atomic_add_fetch(&connections, 1, __ATOMIC_RELAXED);
@@ -328,6 +345,7 @@ static void handler_loop(void* arg) {
     arg = CurrGarage().park();
   }
 }
+#endif
 
 static void acceptor(void* arg) {
 #if defined __U_CPLUSPLUS__
@@ -345,10 +363,16 @@ static void acceptor(void* arg) {
     SYSCALL(setsockopt(connFD, IPPROTO_TCP, TCP_NODELAY, (const void*)&on, sizeof(on)));
 #endif
 #endif
+#if defined __LIBFIBRE__
+    if (!CurrScopeData().pool.run(handler, (void*)connFD)) {
+      __atomic_add_fetch(&connectionFibres, 1, __ATOMIC_RELAXED);
+    }
+#else
     if (!CurrGarage().run((void*)connFD)) {
       __atomic_add_fetch(&connectionFibres, 1, __ATOMIC_RELAXED);
       shim_thread_create(handler_loop, (void*)connFD);
     }
+#endif
   }
 #if defined __U_CPLUSPLUS__
   if (!arg) delete servFD;
@@ -395,8 +419,8 @@ static void* scopemain(void* arg) {
 #endif
     EventScope::bootstrap(pollerCount);
   }
-  Garage garage;
-  Context::CurrEventScope().setClientData(&garage);
+  ScopeData scopeData;
+  Context::CurrEventScope().setClientData(&scopeData);
 #endif
 
 #if defined __LIBFIBRE__ || defined __U_CPLUSPLUS__
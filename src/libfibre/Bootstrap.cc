@@ -71,6 +71,9 @@ EventScope* FibreInit(size_t pollerCount, size_t workerCount) {
 #if TESTING_ENABLE_DEBUGGING
   new (_lfFredDebugLock) WorkerLock;
   new (_lfFredDebugListMemory) FredList<FredDebugLink>;
+#endif
+#if TESTING_STACK_ARENA
+  StackPool::init();
 #endif
   FredStats::StatsReset();
   SYSCALL(atexit(_lfPrintStats));
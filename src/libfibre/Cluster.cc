@@ -15,6 +15,7 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include "libfibre/Cluster.h"
+#include "libfibre/FibrePool.h"
 
 #include <limits.h> // PTHREAD_STACK_MIN
 
@@ -27,6 +28,7 @@ static thread_local EventScope*    currScope    = nullptr;
 
 Fred*          CurrFred()       { RASSERT0(currFred);    return  currFred; }
 BaseProcessor& CurrProcessor()  { RASSERT0(currProc);    return *currProc; }
+BaseProcessor* TryCurrProcessor() {                        return  currProc; }
 Cluster&       CurrCluster()    { RASSERT0(currCluster); return *currCluster; }
 EventScope&    CurrEventScope() { RASSERT0(currScope);   return *currScope; }
 
@@ -61,6 +63,15 @@ void RuntimeWorkerResume(BaseProcessor& proc) {
 }
 #endif
 
+#if TESTING_STEAL_TOPOLOGY
+size_t RuntimeCurrentCpu() {
+  return CpuTopology::currentCpu();
+}
+size_t RuntimeCpuDistance(size_t c1, size_t c2) {
+  return CpuTopology::distance(c1, c2);
+}
+#endif
+
 inline void Cluster::setupWorker(Fibre* fibre, Worker* worker) {
 #ifdef SPLIT_STACK
   stack_t ss = { .ss_sp = new char[SIGSTKSZ], .ss_flags = 0, .ss_size = SIGSTKSZ }; // NOTE: stack allocation never deleted
@@ -99,6 +110,15 @@ inline void Cluster::registerIdleWorker(Worker* worker, Fibre* initFibre) {
   idleFibre->endDirect(_friend<Cluster>());
 }
 
+FibrePool& Cluster::getDetachedPool() {
+  FibrePool* pool = __atomic_load_n(&detachedPool, __ATOMIC_ACQUIRE);
+  if (pool) return *pool;
+  FibrePool* np = new FibrePool(FibrePool::DetachedMax);
+  if (__atomic_compare_exchange_n(&detachedPool, &pool, np, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return *np;
+  delete np;
+  return *pool;
+}
+
 void Cluster::preFork(_friend<EventScope>) {
   ScopedLock<WorkerLock> sl(ringLock);
   RASSERT(ringCount == 1, ringCount);
@@ -110,7 +130,13 @@ void Cluster::postFork(cptr_t parent, _friend<EventScope> fes) {
   for (size_t p = 0; p < iPollCount; p += 1) {
     iPollVec[p].~PollerType();
     new (&iPollVec[p]) PollerType(scope, this, "I-Poller   ", _friend<Cluster>());
+#if TESTING_POLLER_ADAPTIVE
+    iPollVec[p].setAdaptive(iPollActive, iPollCount, _friend<Cluster>());
+#endif
   }
+#if TESTING_POLLER_ADAPTIVE
+  iPollActive = iPollCount;
+#endif
   for (size_t p = 0; p < oPollCount; p += 1) {
     oPollVec[p].~PollerType();
     new (&oPollVec[p]) PollerType(scope, this, "O-Poller   ", _friend<Cluster>());
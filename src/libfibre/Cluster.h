@@ -18,6 +18,7 @@
 #define _Cluster_h_ 1
 
 #include "runtime/Scheduler.h"
+#include "libfibre/CpuTopology.h"
 #include "libfibre/Fibre.h"
 #include "libfibre/Poller.h"
 #if TESTING_WORKER_IO_URING
@@ -26,6 +27,8 @@
 
 #include <list>
 
+class FibrePool;
+
 #ifdef SPLIT_STACK
 #include <csignal>  // sigaltstack
 #endif
@@ -35,6 +38,9 @@ A Cluster object provides a scheduling scope and uses processors (pthreads)
 to execute fibres.  It also manages I/O pollers and provides a
 simple stop-the-world pause mechanism.
 */
+// NOTE: no std::execution (P2300) scheduler adapter: the ready queues only
+// hold Freds (see Fred::resume), so a continuation needs a fibre; FibrePool
+// reuses parked fibres (and their stacks) for short continuations.
 class Cluster : public Scheduler {
   EventScope& scope;
 
@@ -47,6 +53,9 @@ class Cluster : public Scheduler {
   PollerType* oPollVec;
   size_t      iPollCount;
   size_t      oPollCount;
+#if TESTING_POLLER_ADAPTIVE
+  size_t volatile iPollActive; // new registrations: input pollers [0, iPollActive)
+#endif
 
   std::list<Fibre*> pauseFibres;
   WorkerSemaphore   pauseSem;
@@ -55,6 +64,8 @@ class Cluster : public Scheduler {
 
   FredStats::ClusterStats* stats;
 
+  FibrePool* detachedPool;     // created at first use, see fibre_create()
+
   struct Worker : public BaseProcessor {
     pthread_t     sysThreadId;
 #if TESTING_WORKER_IO_URING
@@ -73,8 +84,14 @@ class Cluster : public Scheduler {
 
   static Worker& CurrWorker() { return reinterpret_cast<Worker&>(Context::CurrProcessor()); }
 
-  Cluster(EventScope& es, size_t ipcnt, size_t opcnt = 1) : scope(es), iPollCount(ipcnt), oPollCount(opcnt) {
+  Cluster(EventScope& es, size_t ipcnt, size_t opcnt = 1) : scope(es), iPollCount(ipcnt), oPollCount(opcnt), detachedPool(nullptr) {
+#if TESTING_POLLER_ADAPTIVE
+    iPollActive = ipcnt;
+#endif
     stats = new FredStats::ClusterStats(this, &es);
+#if TESTING_STEAL_TOPOLOGY
+    CpuTopology::init();
+#endif
     iPollVec = (PollerType*)new char[sizeof(PollerType[iPollCount])];
     oPollVec = (PollerType*)new char[sizeof(PollerType[oPollCount])];
   }
@@ -84,7 +101,13 @@ class Cluster : public Scheduler {
       (new (&oPollVec[p]) PollerType(scope, this, "O-Poller   ", _friend<Cluster>()))->start();
     }
     for (size_t p = 0; p < iPollCount; p += 1) {
+#if TESTING_POLLER_ADAPTIVE
+      new (&iPollVec[p]) PollerType(scope, this, "I-Poller   ", _friend<Cluster>());
+      iPollVec[p].setAdaptive(iPollActive, iPollCount, _friend<Cluster>());
+      iPollVec[p].start();
+#else
       (new (&iPollVec[p]) PollerType(scope, this, "I-Poller   ", _friend<Cluster>()))->start();
+#endif
     }
   }
 
@@ -115,6 +138,8 @@ public:
   }
 
   void preFork(_friend<EventScope>);
+  /** Pool of parked fibres for detached fibre_create() on this cluster. */
+  FibrePool& getDetachedPool();
   void postFork(cptr_t parent, _friend<EventScope>);
 
 #if TESTING_WORKER_IO_URING
@@ -176,7 +201,11 @@ public:
   }
 
   /** Get individual access to pollers. */
+#if TESTING_POLLER_ADAPTIVE
+  PollerType&  getInputPoller(size_t hint) { return iPollVec[hint % iPollActive]; }
+#else
   PollerType&  getInputPoller(size_t hint) { return iPollVec[hint % iPollCount]; }
+#endif
   PollerType& getOutputPoller(size_t hint) { return oPollVec[hint % oPollCount]; }
 
   /** Obtain number of pollers */
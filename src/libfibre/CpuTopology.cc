@@ -0,0 +1,95 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "libfibre/CpuTopology.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+size_t  CpuTopology::cpuCount = 0;
+size_t* CpuTopology::coreId   = nullptr;
+size_t* CpuTopology::cacheId  = nullptr;
+size_t* CpuTopology::nodeId   = nullptr;
+
+static pthread_once_t topologyOnce = PTHREAD_ONCE_INIT;
+
+// read leading number from sysfs file, e.g., first cpu from cpu list "0-3,8-11"
+static size_t readFirstNumber(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return CpuTopology::Unknown;
+  char buf[64];
+  ssize_t len = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (len <= 0 || buf[0] < '0' || buf[0] > '9') return CpuTopology::Unknown;
+  buf[len] = 0;
+  return strtoul(buf, nullptr, 10);
+}
+
+void CpuTopology::load() {
+  long cnt = sysconf(_SC_NPROCESSORS_CONF);
+  if (cnt <= 0) return;
+  coreId  = new size_t[cnt];
+  cacheId = new size_t[cnt];
+  nodeId  = new size_t[cnt];
+  char path[128];
+  for (long c = 0; c < cnt; c += 1) {
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/topology/thread_siblings_list", c);
+    coreId[c] = readFirstNumber(path);
+    cacheId[c] = Unknown;
+    size_t maxLevel = 0;
+    for (int idx = 0;; idx += 1) {       // last-level cache: highest level index
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cache/index%d/level", c, idx);
+      size_t level = readFirstNumber(path);
+      if (level == Unknown) break;
+      if (level < maxLevel) continue;
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cache/index%d/shared_cpu_list", c, idx);
+      cacheId[c] = readFirstNumber(path);
+      maxLevel = level;
+    }
+    nodeId[c] = Unknown;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld", c);
+    DIR* dir = opendir(path);
+    if (dir) {
+      while (dirent* de = readdir(dir)) {
+        if (strncmp(de->d_name, "node", 4) == 0 && de->d_name[4] >= '0' && de->d_name[4] <= '9') {
+          nodeId[c] = strtoul(de->d_name + 4, nullptr, 10);
+          break;
+        }
+      }
+      closedir(dir);
+    }
+  }
+  cpuCount = cnt;
+}
+
+void CpuTopology::init() {
+  pthread_once(&topologyOnce, load);
+}
+
+size_t CpuTopology::currentCpu() {
+#if defined(__linux__)
+  int c = sched_getcpu();
+  return (c < 0) ? Unknown : c;
+#else
+  return Unknown;
+#endif
+}
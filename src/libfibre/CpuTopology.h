@@ -0,0 +1,49 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef _CpuTopology_h_
+#define _CpuTopology_h_ 1
+
+#include "runtime/Basics.h"
+
+// CPU topology (Linux: read from /sys), used for work-stealing victim selection and stack placement
+// distance: 0 = same core (SMT sibling), 1 = shared LLC, 2 = same NUMA node, 3 = remote or unknown
+class CpuTopology {
+  static size_t  cpuCount;
+  static size_t* coreId;  // lowest cpu id sharing core
+  static size_t* cacheId; // lowest cpu id sharing last-level cache
+  static size_t* nodeId;  // NUMA node
+  static void load();
+
+public:
+  enum Distance : size_t { Core = 0, Cache = 1, Node = 2, Remote = 3 };
+  static const size_t Unknown = ~size_t(0);
+
+  static void init();                         // idempotent
+  static size_t currentCpu();                 // Unknown, if not available
+  static size_t node(size_t c) {              // Unknown, if not available
+    return c < cpuCount ? nodeId[c] : Unknown;
+  }
+  static size_t distance(size_t c1, size_t c2) {
+    if (c1 >= cpuCount || c2 >= cpuCount) return Remote;
+    if (coreId[c1]  != Unknown && coreId[c1]  == coreId[c2])  return Core;
+    if (cacheId[c1] != Unknown && cacheId[c1] == cacheId[c2]) return Cache;
+    if (nodeId[c1]  != Unknown && nodeId[c1]  == nodeId[c2])  return Node;
+    return Remote;
+  }
+};
+
+#endif /* _CpuTopology_h_ */
@@ -50,11 +50,48 @@ class EventScope {
     BasePoller*     poller[2];
     bool            blocking;
     bool            useUring;
+#if TESTING_EVENTPOLL_READYCACHE
+    bool            ready[2];  // false: drained/full, wait for next edge before trying I/O
+    bool            stream;    // short I/O implies drained/full
+    SyncFD() : poller{nullptr,nullptr}, blocking(false), useUring(false), ready{true,true}, stream(false) {}
+#else
     SyncFD() : poller{nullptr,nullptr}, blocking(false), useUring(false) {}
-  } *fdSyncVector;
+#endif
+  };
 
   int fdCount;
 
+#if TESTING_COMPACT_FDTABLE
+  // two-level table: chunks of SyncFD entries are allocated on first use of any fd in the chunk
+  static const int FdChunkBits = 5;
+  static const int FdChunkSize = 1 << FdChunkBits;
+  SyncFD** fdSyncTable;
+
+  SyncFD* fdSyncChunk(int c) {
+    SyncFD* chunk = new SyncFD[FdChunkSize];
+    SyncFD* exp = nullptr;
+    if (__atomic_compare_exchange_n(&fdSyncTable[c], &exp, chunk, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return chunk;
+    delete [] chunk;                                                        // lost race -> use winner's chunk
+    return exp;
+  }
+
+  SyncFD& fdSync(int fd) {
+    SyncFD* chunk = __atomic_load_n(&fdSyncTable[fd >> FdChunkBits], __ATOMIC_ACQUIRE);
+    if slowpath(!chunk) chunk = fdSyncChunk(fd >> FdChunkBits);
+    return chunk[fd & (FdChunkSize - 1)];
+  }
+
+  SyncFD* fdSyncPeek(int fd) {                                              // no allocation
+    SyncFD* chunk = __atomic_load_n(&fdSyncTable[fd >> FdChunkBits], __ATOMIC_ACQUIRE);
+    return chunk ? &chunk[fd & (FdChunkSize - 1)] : nullptr;
+  }
+#else
+  SyncFD* fdSyncVector;
+
+  SyncFD& fdSync(int fd) { return fdSyncVector[fd]; }
+  SyncFD* fdSyncPeek(int fd) { return &fdSyncVector[fd]; }
+#endif
+
   EventScope*   parentScope;
   MasterPoller* masterPoller; // runs without cluster
   TimerQueue    timerQueue;   // scope-global timer queue
@@ -72,21 +109,87 @@ class EventScope {
 
   FredStats::EventScopeStats* stats;
 
+#if TESTING_STACK_RECLAIM
+  // per-fibre records, pushed lock-free at first blocking I/O; the reclaim fibre
+  // is the only one to unlink (never the head) and delete records of exited fibres
+  typedef Fibre::ReclaimRecord ReclaimRecord;
+  ReclaimRecord* volatile reclaimList;
+  Fibre*                  reclaimFibre;
+
+  ReclaimRecord& reclaimBlock() {
+    Fibre* cf = CurrFibre();
+    ReclaimRecord* rr = cf->getReclaimRecord(_friend<EventScope>());
+    if slowpath(!rr) {
+      rr = new ReclaimRecord(cf);
+      cf->setReclaimRecord(rr, _friend<EventScope>());
+      rr->next = __atomic_load_n(&reclaimList, __ATOMIC_RELAXED);
+      while (!__atomic_compare_exchange_n(&reclaimList, &rr->next, rr, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+    rr->stamp = Runtime::Timer::now();
+    __atomic_store_n(&rr->state, ReclaimRecord::Blocked, __ATOMIC_RELEASE);
+    return *rr;
+  }
+
+  void reclaimUnblock(ReclaimRecord& rr) {
+    for (;;) {                            // wait for trimming in progress
+      ReclaimRecord::State s = __atomic_load_n(&rr.state, __ATOMIC_ACQUIRE);
+      if (s != ReclaimRecord::Trimming && __atomic_compare_exchange_n(&rr.state, &s, ReclaimRecord::Running, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+      Pause();
+    }
+  }
+
+  void reclaimSweep() {
+    Time limit = Runtime::Timer::now() - Time(TESTING_STACK_RECLAIM, 0);
+    ReclaimRecord* prev = __atomic_load_n(&reclaimList, __ATOMIC_ACQUIRE);
+    if (!prev) return;
+    for (ReclaimRecord* rr = prev;;) {
+      ReclaimRecord::State s = __atomic_load_n(&rr->state, __ATOMIC_ACQUIRE);
+      if (s == ReclaimRecord::Blocked && rr->stamp < limit
+        && __atomic_compare_exchange_n(&rr->state, &s, ReclaimRecord::Trimming, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        rr->fibre->stackTrim();           // no-op, if fibre running already
+        __atomic_store_n(&rr->state, ReclaimRecord::Trimmed, __ATOMIC_RELEASE);
+      }
+      prev = rr;
+      rr = rr->next;
+      while (rr && __atomic_load_n(&rr->state, __ATOMIC_ACQUIRE) == ReclaimRecord::Exited) {
+        prev->next = rr->next;
+        delete rr;
+        rr = prev->next;
+      }
+      if (!rr) break;
+    }
+  }
+
+  static void reclaimLoop(EventScope* This) {
+    for (;;) {
+      Fibre::sleep(TESTING_STACK_RECLAIM / 2 + 1);
+      This->reclaimSweep();
+    }
+  }
+#endif
+
   // TODO: not available until cluster deletion implemented
   ~EventScope() {
     delete mainFibre;
     delete mainCluster;
     masterPoller->terminate(_friend<EventScope>());
     delete masterPoller;
+#if TESTING_COMPACT_FDTABLE
+    for (int c = 0; c < (fdCount + FdChunkSize - 1) >> FdChunkBits; c += 1) delete [] fdSyncTable[c];
+    delete [] fdSyncTable;
+#else
     delete[] fdSyncVector;
+#endif
   }
 
   static void cloneInternal(EventScope* This) {
     This->initSync();
     RASSERT0(This->parentScope);
     for (int f = 0; f < This->fdCount; f += 1) {
-      This->fdSyncVector[f].blocking = This->parentScope->fdSyncVector[f].blocking;
-      This->fdSyncVector[f].useUring = This->parentScope->fdSyncVector[f].useUring;
+      SyncFD* pfd = This->parentScope->fdSyncPeek(f);
+      if (!pfd || (!pfd->blocking && !pfd->useUring)) continue;           // default settings
+      This->fdSync(f).blocking = pfd->blocking;
+      This->fdSync(f).useUring = pfd->useUring;
     }
 #if defined(__linux__)
     SYSCALL(unshare(CLONE_FILES));
@@ -98,6 +201,9 @@ class EventScope {
 
   EventScope(size_t pollerCount, EventScope* ps = nullptr) : parentScope(ps), timerQueue(this), diskCluster(nullptr) {
     RASSERT0(pollerCount > 0);
+#if TESTING_STACK_RECLAIM
+    reclaimList = nullptr;
+#endif
     stats = new FredStats::EventScopeStats(this, nullptr);
     mainCluster = new Cluster(*this, pollerCount, _friend<EventScope>());   // create main cluster
   }
@@ -108,23 +214,40 @@ class EventScope {
     rl.rlim_max = rl.rlim_cur;                                              // firm up current FD limit
     SYSCALL(setrlimit(RLIMIT_NOFILE, &rl));                                 // and install maximum
     fdCount = rl.rlim_max + MasterPoller::extraTimerFD;                     // add fake timer fd, if necessary
+#if TESTING_COMPACT_FDTABLE
+    fdSyncTable = new SyncFD*[(fdCount + FdChunkSize - 1) >> FdChunkBits](); // chunks of R/W sync points allocated later
+#else
     fdSyncVector = new SyncFD[fdCount];                                     // create vector of R/W sync points
+#endif
   }
 
   void start() {
     masterPoller = new MasterPoller(*this, fdCount, _friend<EventScope>()); // start master poller & timer handling
     mainCluster->startPolling(_friend<EventScope>());                       // start polling now (potentially new event scope)
+#if TESTING_STACK_RECLAIM
+    reclaimFibre = new Fibre(*mainCluster);                                 // periodic stack reclamation
+    reclaimFibre->setName("s:Reclaim")->run(reclaimLoop, this);
+#endif
   }
 
   void cleanupFD(int fd) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    SyncFD& fdsync = fdSyncVector[fd];
+    SyncFD& fdsync = fdSync(fd);
+#if TESTING_EVENTPOLL_BATCHCTL
+    if (fdsync.poller[false]) fdsync.poller[false]->cancelRearm(fd);
+    if (fdsync.poller[true] && fdsync.poller[true] != fdsync.poller[false]) fdsync.poller[true]->cancelRearm(fd);
+#endif
     fdsync.sync[false].reset();
     fdsync.sync[true].reset();
     fdsync.poller[false] = nullptr;
     fdsync.poller[true] = nullptr;
     fdsync.blocking = false;
     fdsync.useUring = false;
+#if TESTING_EVENTPOLL_READYCACHE
+    fdsync.ready[false] = true;
+    fdsync.ready[true] = true;
+    fdsync.stream = false;
+#endif
   }
 
   template<bool Input, bool Cluster>
@@ -136,6 +259,18 @@ class EventScope {
     return Context::CurrCluster().getInputPoller(fd);
   }
 
+#if TESTING_EVENTPOLL_COMBINED
+  template<bool Cluster>
+  void registerCombined(int fd) {           // one edge-triggered registration for both directions
+    SyncFD& fdsync = fdSync(fd);
+    BasePoller* poller = &getPoller<true,Cluster>(fd);
+    BasePoller* exp = nullptr;
+    if (!__atomic_compare_exchange_n(&fdsync.poller[true], &exp, poller, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return;
+    poller->setupFD(fd, Poller::Create, Poller::Direction(Poller::Input | Poller::Output), Poller::Edge);
+    fdsync.poller[false] = poller;
+  }
+#endif
+
   template<bool Input>
   inline bool TestEAGAIN() {
     int serrno = _SysErrno();
@@ -160,9 +295,13 @@ class EventScope {
   template<bool Input, bool Accept, typename T, class... Args>
   T syncIO( T (*iofunc)(int, Args...), int fd, Args... a) {
     T ret;
+#if !TESTING_EVENTPOLL_READYCACHE
     static const bool Read = Input && !Accept;
+#endif
     static const Poller::Direction direction = Input ? Poller::Input : Poller::Output;
-#if TESTING_EVENTPOLL_EDGE
+#if TESTING_EVENTPOLL_READYCACHE
+    static const Poller::Variant variant = Poller::Edge;
+#elif TESTING_EVENTPOLL_EDGE
     static const Poller::Variant variant = Input ? Poller::Edge : Poller::Oneshot;
 #elif TESTING_EVENTPOLL_ONESHOT
     static const Poller::Variant variant = Poller::Oneshot;
@@ -171,6 +310,13 @@ class EventScope {
 #else // level
     static const Poller::Variant variant = Read ? Poller::Level : Poller::Oneshot;
 #endif
+#if TESTING_EVENTPOLL_READYCACHE
+    bool& ready = fdSync(fd).ready[Input];
+    if (ready) {                                 // skip I/O attempt, if known to fail
+      if (tryIO<Input>(ret, iofunc, fd, a...)) return ret;
+      ready = false;
+    }
+#else
     if (Read) {
 #if TESTING_EVENTPOLL_TRYREAD
       Fibre::yield();
@@ -179,27 +325,51 @@ class EventScope {
     } else {
       if (tryIO<Input>(ret, iofunc, fd, a...)) return ret;
     }
-    BasePoller*& poller = fdSyncVector[fd].poller[Input];
+#endif
+    BasePoller*& poller = fdSync(fd).poller[Input];
     if (!poller) {
+#if TESTING_EVENTPOLL_COMBINED
+      registerCombined<Accept>(fd);
+#else
       poller = &getPoller<Input,Accept>(fd);
       poller->setupFD(fd, Poller::Create, direction, variant);
+#endif
     } else if (variant == Poller::Oneshot) {
-      poller->setupFD(fd, Poller::Modify, direction, variant);
+      poller->rearmFD(fd, direction, variant);
     }
-    Poller::SyncSem& sync = fdSyncVector[fd].sync[Input];
+    Poller::SyncSem& sync = fdSync(fd).sync[Input];
     for (;;) {
+#if TESTING_STACK_RECLAIM
+      ReclaimRecord& rr = reclaimBlock();
+#endif
       if (variant == Poller::Level) sync.wait(); else sync.P();
-      if (tryIO<Input>(ret, iofunc, fd, a...)) return ret;
+#if TESTING_STACK_RECLAIM
+      reclaimUnblock(rr);
+#endif
+      if (tryIO<Input>(ret, iofunc, fd, a...)) {
+#if TESTING_EVENTPOLL_READYCACHE
+        ready = true;
+#endif
+        return ret;
+      }
       if (variant == Poller::Oneshot) {
-        poller->setupFD(fd, Poller::Modify, direction, variant);
+        poller->rearmFD(fd, direction, variant);
       }
     }
   }
 
   int checkAsyncCompletion(int fd) {
-    SyncFD& fdsync = fdSyncVector[fd];
+    SyncFD& fdsync = fdSync(fd);
+#if TESTING_EVENTPOLL_COMBINED
+    registerCombined<false>(fd);
+#else
     fdsync.poller[false] = &getPoller<false,false>(fd);
+#if TESTING_EVENTPOLL_READYCACHE
+    fdsync.poller[false]->setupFD(fd, Poller::Create, Poller::Output, Poller::Edge);    // register once
+#else
     fdsync.poller[false]->setupFD(fd, Poller::Create, Poller::Output, Poller::Oneshot); // register immediately
+#endif
+#endif
     fdsync.sync[false].P();                                                             // wait for completion
     int err;
     socklen_t sz = sizeof(err);
@@ -217,6 +387,17 @@ class EventScope {
     return syncIO<false,false>(writefunc, fd, a...); // no yield before write
   }
 
+  template<bool Input, typename T>
+  T shortIO(int fd, size_t length, T ret) {
+#if TESTING_EVENTPOLL_READYCACHE
+    SyncFD& fdsync = fdSync(fd);            // stream: short transfer -> drained/full until next edge
+    if (fdsync.stream && ret > 0 && size_t(ret) < length) fdsync.ready[Input] = false;
+#else
+    (void)fd; (void)length;
+#endif
+    return ret;
+  }
+
 public:
   /** Create an event scope during bootstrap. */
   static EventScope* bootstrap(std::list<size_t>& cpulist, size_t pollerCount = 1, size_t workerCount = 1) {
@@ -266,10 +447,12 @@ public:
     RASSERT0(diskCluster == nullptr);
     mainCluster->preFork(_friend<EventScope>());
     for (int f = 0; f < fdCount; f += 1) {
-      RASSERT(fdSyncVector[f].sync[false].getValue() >= 0, f);
-      RASSERT(fdSyncVector[f].sync[true].getValue() >= 0, f);
-      RASSERT(fdSyncVector[f].poller[false] == 0, f);
-      RASSERT(fdSyncVector[f].poller[true] == 0, f);
+      SyncFD* fds = fdSyncPeek(f);
+      if (!fds) continue;
+      RASSERT(fds->sync[false].getValue() >= 0, f);
+      RASSERT(fds->sync[true].getValue() >= 0, f);
+      RASSERT(fds->poller[false] == 0, f);
+      RASSERT(fds->poller[true] == 0, f);
     }
   }
 
@@ -307,20 +490,20 @@ public:
 
   bool tryblock(int fd, _friend<MasterPoller>) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    return fdSyncVector[fd].sync[true].tryP();
+    return fdSync(fd).sync[true].tryP();
   }
 
 #if TESTING_WORKER_POLLER
   bool tryblock(int fd, _friend<WorkerPoller>) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    return fdSyncVector[fd].sync[true].tryP();
+    return fdSync(fd).sync[true].tryP();
   }
 #endif
 
   template<bool Input, bool Enqueue = true>
   Fred* unblock(int fd, _friend<BasePoller>) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    return fdSyncVector[fd].sync[Input].V<Enqueue>();
+    return fdSync(fd).sync[Input].V<Enqueue>();
   }
 
   void registerPollFD(int fd, _friend<PollerFibre>) {
@@ -331,12 +514,12 @@ public:
   void blockPollFD(int fd, _friend<PollerFibre>) {
     RASSERT0(fd >= 0 && fd < fdCount);
     masterPoller->setupFD(fd, Poller::Modify, Poller::Input, Poller::Oneshot);
-    fdSyncVector[fd].sync[true].P();
+    fdSync(fd).sync[true].P();
   }
 
   void unblockPollFD(int fd, _friend<PollerFibre>) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    fdSyncVector[fd].sync[true].V();
+    fdSync(fd).sync[true].V();
   }
 
   template<typename T, class... Args>
@@ -351,14 +534,14 @@ public:
   template<typename T, class... Args>
   T syncInput( T (*readfunc)(int, Args...), int fd, Args... a) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return readfunc(fd, a...);
+    if (!fdSync(fd).blocking) return readfunc(fd, a...);
     return blockingInput(readfunc, fd, a...);
   }
 
   template<typename T, class... Args>
   T syncOutput( T (*writefunc)(int, Args...), int fd, Args... a) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return writefunc(fd, a...);
+    if (!fdSync(fd).blocking) return writefunc(fd, a...);
     return blockingOutput(writefunc, fd, a...);
   }
 
@@ -369,14 +552,14 @@ public:
     int ret = ::epoll_wait(epfd, events, maxevents, 0);
     if (ret != 0 || timeout == 0) return ret;
     stats->fails.count();
-    BasePoller*& poller = fdSyncVector[epfd].poller[true];
+    BasePoller*& poller = fdSync(epfd).poller[true];
     if (!poller) {
       poller = &getPoller<true,false>(epfd);
       poller->setupFD(epfd, Poller::Create, Poller::Input, Poller::Oneshot);
     } else {
-      poller->setupFD(epfd, Poller::Modify, Poller::Input, Poller::Oneshot);
+      poller->rearmFD(epfd, Poller::Input, Poller::Oneshot);
     }
-    Poller::SyncSem& sync = fdSyncVector[epfd].sync[true];
+    Poller::SyncSem& sync = fdSync(epfd).sync[true];
     Time absTimeout;
     if (timeout > 0) absTimeout = Runtime::Timer::now() + Time::fromMS(timeout);
     for (;;) {
@@ -386,7 +569,7 @@ public:
       ret = ::epoll_wait(epfd, events, maxevents, 0);
       if (ret != 0) return ret;
       stats->fails.count();
-      poller->setupFD(epfd, Poller::Modify, Poller::Input, Poller::Oneshot);
+      poller->rearmFD(epfd, Poller::Input, Poller::Oneshot);
     }
   }
 #endif
@@ -394,18 +577,21 @@ public:
   int socket(int domain, int type, int protocol, bool useUring) {
     int ret = ::socket(domain, type | (useUring ? 0 : SOCK_NONBLOCK), protocol);
     if (ret < 0) return ret;
-    fdSyncVector[ret].blocking = !(type & SOCK_NONBLOCK);
-    fdSyncVector[ret].useUring = useUring;
+    fdSync(ret).blocking = !(type & SOCK_NONBLOCK);
+    fdSync(ret).useUring = useUring;
+#if TESTING_EVENTPOLL_READYCACHE
+    fdSync(ret).stream = (type & ~(SOCK_NONBLOCK | SOCK_CLOEXEC)) == SOCK_STREAM;
+#endif
     return ret;
   }
 
 #if TESTING_WORKER_IO_URING
-  inline bool uring(int fd) { return fdSyncVector[fd].useUring; }
+  inline bool uring(int fd) { return fdSync(fd).useUring; }
 #endif
 
   int bind(int fd, const sockaddr *addr, socklen_t addrlen) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::bind(fd, addr, addrlen);
+    if (!fdSync(fd).blocking) return ::bind(fd, addr, addrlen);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return ::bind(fd, addr, addrlen);
 #endif
@@ -423,7 +609,7 @@ public:
 
   int connect(int fd, const sockaddr *addr, socklen_t addrlen) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::connect(fd, addr, addrlen);
+    if (!fdSync(fd).blocking) return ::connect(fd, addr, addrlen);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_connect, fd, addr, addrlen);
 #endif
@@ -445,17 +631,20 @@ public:
     int ret;
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) {
-      ret = fdSyncVector[fd].blocking
+      ret = fdSync(fd).blocking
           ? Cluster::getWorkerUring().syncIO(io_uring_prep_accept, fd, addr, addrlen, flags)
           : ::accept4(fd, addr, addrlen, flags);
     } else
 #endif
-    ret = fdSyncVector[fd].blocking
+    ret = fdSync(fd).blocking
         ? syncIO<true,true>(::accept4, fd, addr, addrlen, flags | SOCK_NONBLOCK)
         : ::accept4(fd, addr, addrlen, flags | SOCK_NONBLOCK);
     if (ret < 0) return ret;
-    fdSyncVector[ret].blocking = !(flags & SOCK_NONBLOCK);
-    fdSyncVector[ret].useUring = fdSyncVector[fd].useUring;
+    fdSync(ret).blocking = !(flags & SOCK_NONBLOCK);
+    fdSync(ret).useUring = fdSync(fd).useUring;
+#if TESTING_EVENTPOLL_READYCACHE
+    fdSync(ret).stream = fdSync(fd).stream;
+#endif
     stats->srvconn.count();
     return ret;
   }
@@ -463,26 +652,33 @@ public:
   int dup(int fd) {
     int ret = ::dup(fd);
     if (ret < 0) return ret;
-    fdSyncVector[ret].blocking = fdSyncVector[fd].blocking;
-    fdSyncVector[ret].useUring = fdSyncVector[fd].useUring;
+    fdSync(ret).blocking = fdSync(fd).blocking;
+    fdSync(ret).useUring = fdSync(fd).useUring;
+#if TESTING_EVENTPOLL_READYCACHE
+    fdSync(ret).stream = fdSync(fd).stream;
+#endif
     return ret;
   }
 
   int pipe2(int pipefd[2], int flags, bool useUring) {
     int ret = ::pipe2(pipefd, flags | (useUring ? 0 : O_NONBLOCK));
     if (ret < 0) return ret;
-    fdSyncVector[pipefd[0]].blocking = !(flags & O_NONBLOCK);
-    fdSyncVector[pipefd[0]].useUring = useUring;
-    fdSyncVector[pipefd[1]].blocking = !(flags & O_NONBLOCK);
-    fdSyncVector[pipefd[1]].useUring = useUring;
+    fdSync(pipefd[0]).blocking = !(flags & O_NONBLOCK);
+    fdSync(pipefd[0]).useUring = useUring;
+    fdSync(pipefd[1]).blocking = !(flags & O_NONBLOCK);
+    fdSync(pipefd[1]).useUring = useUring;
+#if TESTING_EVENTPOLL_READYCACHE
+    fdSync(pipefd[0]).stream = !(flags & O_DIRECT);
+    fdSync(pipefd[1]).stream = !(flags & O_DIRECT);
+#endif
     return ret;
   }
 
   int fcntl(int fd, int cmd, int flags) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    int ret = ::fcntl(fd, cmd, flags | (fdSyncVector[fd].useUring ? 0 : O_NONBLOCK));
+    int ret = ::fcntl(fd, cmd, flags | (fdSync(fd).useUring ? 0 : O_NONBLOCK));
     if (ret < 0) return ret;
-    fdSyncVector[fd].blocking = !(flags & O_NONBLOCK);
+    fdSync(fd).blocking = !(flags & O_NONBLOCK);
     return ret;
   }
 
@@ -493,16 +689,16 @@ public:
 
   int read(int fd, void *buf, size_t nbyte) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::read(fd, buf, nbyte);
+    if (!fdSync(fd).blocking) return ::read(fd, buf, nbyte);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_read, fd, buf, (unsigned)nbyte, (UringOffsetType)0);
 #endif
-    return blockingInput(::read, fd, buf, nbyte);
+    return shortIO<true>(fd, nbyte, blockingInput(::read, fd, buf, nbyte));
   }
 
   int pread(int fd, void *buf, size_t nbyte, off_t offset) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::pread(fd, buf, nbyte, offset);
+    if (!fdSync(fd).blocking) return ::pread(fd, buf, nbyte, offset);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_read, fd, buf, (unsigned)nbyte, (UringOffsetType)offset);
 #endif
@@ -511,7 +707,7 @@ public:
 
   int readv(int fd, const struct iovec *iovecs, int nr_vecs) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::readv(fd, iovecs, nr_vecs);
+    if (!fdSync(fd).blocking) return ::readv(fd, iovecs, nr_vecs);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_readv, fd, iovecs, (unsigned)nr_vecs, (UringOffsetType)0);
 #endif
@@ -520,7 +716,7 @@ public:
 
   int preadv(int fd, const struct iovec *iovecs, int nr_vecs, off_t offset) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::preadv(fd, iovecs, nr_vecs, offset);
+    if (!fdSync(fd).blocking) return ::preadv(fd, iovecs, nr_vecs, offset);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_readv, fd, iovecs, (unsigned)nr_vecs, (UringOffsetType)offset);
 #endif
@@ -529,16 +725,16 @@ public:
 
   int write(int fd, const void *buf, size_t nbyte) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::write(fd, buf, nbyte);
+    if (!fdSync(fd).blocking) return ::write(fd, buf, nbyte);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_write, fd, buf, (unsigned)nbyte, (UringOffsetType)0);
 #endif
-    return blockingOutput(::write, fd, buf, nbyte);
+    return shortIO<false>(fd, nbyte, blockingOutput(::write, fd, buf, nbyte));
   }
 
   int pwrite(int fd, const void *buf, size_t nbyte, off_t offset) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::pwrite(fd, buf, nbyte, offset);
+    if (!fdSync(fd).blocking) return ::pwrite(fd, buf, nbyte, offset);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_write, fd, buf, (unsigned)nbyte, (UringOffsetType)offset);
 #endif
@@ -547,7 +743,7 @@ public:
 
   int writev(int fd, const struct iovec *iovecs, int nr_vecs) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::writev(fd, iovecs, nr_vecs);
+    if (!fdSync(fd).blocking) return ::writev(fd, iovecs, nr_vecs);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_writev, fd, iovecs, (unsigned)nr_vecs, (UringOffsetType)0);
 #endif
@@ -556,7 +752,7 @@ public:
 
   int pwritev(int fd, const struct iovec *iovecs, int nr_vecs, off_t offset) {
     RASSERT0(fd >= 0 && fd < fdCount);
-    if (!fdSyncVector[fd].blocking) return ::pwritev(fd, iovecs, nr_vecs, offset);
+    if (!fdSync(fd).blocking) return ::pwritev(fd, iovecs, nr_vecs, offset);
 #if TESTING_WORKER_IO_URING
     if (uring(fd)) return Cluster::getWorkerUring().syncIO(io_uring_prep_writev, fd, iovecs, (unsigned)nr_vecs, (UringOffsetType)offset);
 #endif
@@ -565,7 +761,7 @@ public:
 
   ssize_t sendmsg(int socket, const struct msghdr *message, int flags) {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::sendmsg(socket, message, flags);
+    if (!fdSync(socket).blocking) return ::sendmsg(socket, message, flags);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) return Cluster::getWorkerUring().syncIO(io_uring_prep_sendmsg, socket, message, (unsigned)flags);
 #endif
@@ -574,7 +770,7 @@ public:
 
   ssize_t sendto(int socket, const void *message, size_t length, int flags, const struct sockaddr *dest_addr, socklen_t dest_len) {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::sendto(socket, message, length, flags, dest_addr, dest_len);
+    if (!fdSync(socket).blocking) return ::sendto(socket, message, length, flags, dest_addr, dest_len);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) {
       struct iovec iov = { .iov_base = (void*)message, .iov_len = length };
@@ -588,16 +784,16 @@ public:
 
   ssize_t send(int socket, const void *buffer, size_t length, int flags) {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::send(socket, buffer, length, flags);
+    if (!fdSync(socket).blocking) return ::send(socket, buffer, length, flags);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) return Cluster::getWorkerUring().syncIO(io_uring_prep_send, socket, buffer, length, flags);
 #endif
-    return blockingOutput(::send, socket, buffer, length, flags);
+    return shortIO<false>(socket, length, blockingOutput(::send, socket, buffer, length, flags));
   }
 
   ssize_t recvmsg(int socket, struct msghdr *message, int flags) {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::recvmsg(socket, message, flags);
+    if (!fdSync(socket).blocking) return ::recvmsg(socket, message, flags);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) return Cluster::getWorkerUring().syncIO(io_uring_prep_recvmsg, socket, message, (unsigned)flags);
 #endif
@@ -606,7 +802,7 @@ public:
 
   ssize_t recvfrom(int socket, void *restrict buffer, size_t length, int flags, struct sockaddr *restrict address, socklen_t *restrict address_len)  {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::recvfrom(socket, buffer, length, flags, address, address_len);
+    if (!fdSync(socket).blocking) return ::recvfrom(socket, buffer, length, flags, address, address_len);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) {
       struct iovec iov = { .iov_base = buffer, .iov_len = length };
@@ -622,11 +818,11 @@ public:
 
   ssize_t recv(int socket, void *buffer, size_t length, int flags) {
     RASSERT0(socket >= 0 && socket < fdCount);
-    if (!fdSyncVector[socket].blocking) return ::recv(socket, buffer, length, flags);
+    if (!fdSync(socket).blocking) return ::recv(socket, buffer, length, flags);
 #if TESTING_WORKER_IO_URING
     if (uring(socket)) return Cluster::getWorkerUring().syncIO(io_uring_prep_recv, socket, buffer, length, flags);
 #endif
-    return blockingInput(::recv, socket, buffer, length, flags);
+    return shortIO<true>(socket, (flags & MSG_PEEK) ? 0 : length, blockingInput(::recv, socket, buffer, length, flags));
   }
 };
 
@@ -22,10 +22,22 @@
 #include "runtime/BaseProcessor.h"
 #include "runtime/BlockingSync.h"
 #include "runtime-glue/RuntimeContext.h"
+#if TESTING_STACK_CACHE
+#include "libfibre/StackPool.h"
+#endif
+#if TESTING_STACK_PROFILE
+#include "libfibre/StackProfile.h"
+#endif
 
 #include <vector>
 #include <string>
-#include <sys/mman.h> // mmap, munmap, mprotect
+#include <sys/mman.h> // mmap, munmap, mprotect, madvise
+#if TESTING_STACK_RECLAIM
+#include <csignal>    // MINSIGSTKSZ
+#if defined(__linux__)
+#include <sys/auxv.h> // getauxval
+#endif
+#endif
 
 extern size_t _lfPagesize; // Bootstrap.cc
 
@@ -115,14 +127,36 @@ public:
 
 private:
   FloatingPointFlags fp;       // FP context
+#if TESTING_LAZY_FPFLAGS
+  bool fpSave;                 // false: fibre does not change FP flags
+#endif
   size_t stackSize;            // stack size (including guard)
 #ifdef SPLIT_STACK
   void* splitStackContext[10]; // memory for split-stack context
 #else
   vaddr stackBottom;           // bottom of allocated memory for stack (including guard)
+  size_t stackGuard;           // guard size
+#endif
+#if TESTING_STACK_PROFILE
+  ptr_t stackEntry;            // entry function (profile key)
+  bool stackSampled;           // stack canary-filled for profiling
 #endif
   SyncPoint<WorkerLock> done;  // synchronization (join) at destructor
   ptr_t result;                // result transferred to join
+#if TESTING_STACK_RECLAIM
+public:
+  // blocking I/O state, see EventScope::reclaimSweep(); owned by EventScope after exit
+  struct ReclaimRecord {
+    enum State : size_t { Running, Blocked, Trimming, Trimmed, Exited };
+    ReclaimRecord* next;
+    Fibre*         fibre;
+    Time           stamp;
+    State volatile state;
+    ReclaimRecord(Fibre* f) : next(nullptr), fibre(f), state(Running) {}
+  };
+private:
+  ReclaimRecord* reclaimRecord; // created at first blocking I/O
+#endif
 #if TESTING_ENABLE_DEBUGGING
   std::string name;
 #endif
@@ -133,6 +167,10 @@ private:
     vaddr stackBottom = (vaddr)__splitstack_makecontext(size, splitStackContext, &size);
     int off = 0; // do not block signals (blocking signals is slow!)
     __splitstack_block_signals_context(splitStackContext, &off, nullptr);
+#elif TESTING_STACK_CACHE
+    stackBottom = StackPool::alloc(size, guard);
+    stackGuard = guard;
+    size += guard;
 #else
     // check that requested size/guard is a multiple of page size
     RASSERT(aligned(size, _lfPagesize), size);
@@ -145,19 +183,73 @@ private:
     // set up protection page
     if (guard) SYSCALL(mprotect(ptr, guard, PROT_NONE));
     stackBottom = vaddr(ptr);
+    stackGuard = guard;
+#endif
+#if TESTING_STACK_PROFILE
+    stackSampled = StackProfile::sample();
+    if (stackSampled) StackProfile::fill(stackBottom + guard, stackBottom + size);
 #endif
     Fred::initStackPointer(stackBottom + size);
     return size;
   }
 
+#if TESTING_LAZY_STACK
+  size_t stackDefer(size_t size, size_t guard) {
+    stackBottom = 0;
+    stackGuard = guard;
+    return size + guard;
+  }
+#endif
+
+#if TESTING_STACK_PROFILE
+  void stackMeasure() {
+#if TESTING_LAZY_STACK
+    if (!stackBottom) return;
+#endif
+    if (stackSize && stackSampled) StackProfile::record(stackEntry, stackBottom + stackGuard, stackBottom + stackSize);
+  }
+
+  void stackSetEntry(ptr_t func) {
+    stackEntry = func;
+#if TESTING_STACK_AUTOSIZE
+    size_t size = StackProfile::suggest(func, stackSize - stackGuard);
+    if (size + stackGuard == stackSize) return;
+#if TESTING_LAZY_STACK
+    if (!stackBottom) { stackSize = size + stackGuard; return; }
+#endif
+#if TESTING_STACK_CACHE
+    // eager stack: only swap for a cached one, a new mapping costs more than it saves
+    if (!StackPool::cached(size, stackGuard)) return;
+    stackFree();
+    stackSize = stackAlloc(size, stackGuard);
+#endif
+#endif
+  }
+#endif
+
   void stackFree() {
 #ifdef SPLIT_STACK
     if (stackSize) __splitstack_releasecontext(splitStackContext);
+#elif TESTING_STACK_CACHE
+    if (stackSize) StackPool::free(stackBottom, stackSize - stackGuard, stackGuard);
 #else
     if (stackSize) SYSCALL(munmap(ptr_t(stackBottom), stackSize));
 #endif
   }
 
+  void initFloatingPoint() {
+#if TESTING_LAZY_FPFLAGS
+    fp.save();                 // inherit creator's flags (restored at first switch)
+    fpSave = true;
+#endif
+  }
+
+  void initReclaim() {
+#if TESTING_STACK_RECLAIM
+    reclaimRecord = nullptr;
+#endif
+  }
+
   void initDebug() {
 #if TESTING_ENABLE_DEBUGGING
     ScopedLock<WorkerLock> sl(*_lfFredDebugLock);
@@ -173,6 +265,9 @@ private:
   }
 
   void start(ptr_t func, ptr_t p1, ptr_t p2, ptr_t p3) { // hide base class start()
+#if TESTING_STACK_PROFILE
+    stackSetEntry(func);
+#endif
     Fred::start(func, p1, p2, p3);
   }
 
@@ -181,17 +276,29 @@ private:
     return this;
   }
 
+  Fibre* runDirectInternal(ptr_t func, ptr_t p1, ptr_t p2, Fibre* This) {
+#if TESTING_STACK_PROFILE
+    stackSetEntry(func);
+#endif
+    Fred::startDirect(func, p1, p2, This);
+    return this;
+  }
+
 public:
   struct ExitException {};
 
   /** Constructor. */
   Fibre(Scheduler& sched = Context::CurrProcessor().getScheduler(), size_t size = DefaultStackSize, size_t guard = DefaultStackGuard)
-  : Fred(sched), stackSize(stackAlloc(size, guard)) { initDebug(); }
+#if TESTING_LAZY_STACK
+  : Fred(sched), stackSize(stackDefer(size, guard)) { initFloatingPoint(); initReclaim(); initDebug(); }
+#else
+  : Fred(sched), stackSize(stackAlloc(size, guard)) { initFloatingPoint(); initReclaim(); initDebug(); }
+#endif
 
   // system constructor for idle/main loop (bootstrap) on existing pthread stack (size = 0)
   // system constructor with setting affinity to processor (size != 0)
   Fibre(BaseProcessor &p, _friend<Cluster>, size_t size = DefaultStackSize, size_t guard = DefaultStackGuard)
-  : Fred(p), stackSize(size ? stackAlloc(size, guard) : 0) { initDebug(); }
+  : Fred(p), stackSize(size ? stackAlloc(size, guard) : 0) { initFloatingPoint(); initReclaim(); initDebug(); }
 
   //  explicit final notification for idle loop or main loop (bootstrap) on pthread stack
   void endDirect(_friend<Cluster>) { done.post(); }
@@ -211,17 +318,74 @@ public:
     clearSpecific();
   }
 
+#if TESTING_LAZY_STACK
+  // callback from Fred via Runtime before first context switch
+  void bindStack(_friend<Fred>) {
+    stackSize = stackAlloc(stackSize - stackGuard, stackGuard); // pool might round up size
+  }
+#endif
+
+#if TESTING_STACK_RECLAIM
+  ReclaimRecord* getReclaimRecord(_friend<EventScope>) { return reclaimRecord; }
+  void setReclaimRecord(ReclaimRecord* rr, _friend<EventScope>) { reclaimRecord = rr; }
+
+  // Release memory below saved stack pointer of blocked fibre. Once resumed,
+  // the fibre waits in EventScope::reclaimUnblock() at a shallower call depth,
+  // so only a signal delivered meanwhile can reach below the saved stack pointer:
+  // margin = red zone + kernel signal frame (AT_MINSIGSTKSZ) + one page for the handler.
+  // Handlers that need more stack must run on an alternate signal stack.
+  static size_t stackTrimMargin() {
+#if defined(__x86_64__)
+    static const size_t RedZone = 128;
+#else
+    static const size_t RedZone = 0;
+#endif
+#if defined(AT_MINSIGSTKSZ)
+    size_t frame = getauxval(AT_MINSIGSTKSZ); // actual frame size (xsave state)
+    if (!frame) frame = MINSIGSTKSZ;
+#else
+    size_t frame = MINSIGSTKSZ;
+#endif
+    return align_up(RedZone + frame + _lfPagesize, _lfPagesize);
+  }
+
+  void stackTrim() {
+    static const size_t margin = stackTrimMargin();
+    vaddr sp = Fred::getStackPointer();
+    if (!sp || !stackSize) return; // running or on pthread stack
+    vaddr lo = stackBottom + stackGuard;
+    vaddr top = align_down(sp, _lfPagesize);
+    if (top > lo + margin) SYSCALL(madvise(ptr_t(lo), top - margin - lo, MADV_DONTNEED));
+  }
+#endif
+
   // callback from Fred via Runtime after final context switch
   void destroy(_friend<Fred>) {
     clearDebug();
+#if TESTING_STACK_RECLAIM
+    if (reclaimRecord) __atomic_store_n(&reclaimRecord->state, ReclaimRecord::Exited, __ATOMIC_RELEASE);
+#endif
+#if TESTING_STACK_PROFILE
+    stackMeasure();
+#endif
     stackFree();
     done.post();
   }
 
   void setup(ptr_t func, ptr_t p1, ptr_t p2, ptr_t p3, _friend<Cluster>) { // hide base class setup()
+#if TESTING_STACK_PROFILE
+    stackEntry = func;
+#endif
     Fred::setup(func, p1, p2, p3);
   }
 
+#if TESTING_LAZY_FPFLAGS
+  /** Opt out of FP flags save on context switch (fibre does not change MXCSR/x87 control word). */
+  Fibre* setFloatingPoint(bool save) { fpSave = save; return this; }
+#else
+  Fibre* setFloatingPoint(bool) { return this; }
+#endif
+
 #if TESTING_ENABLE_DEBUGGING
   Fibre* setName(const std::string& n) {
     name = n.size() >= 2 && n[1] == ':' ? n : "u:" + n;
@@ -248,6 +412,21 @@ public:
     return runInternal((ptr_t)func, (ptr_t)p1, nullptr, this);
   }
 
+  /** Start fibre child-first: run immediately on current worker, caller continues later. */
+  Fibre* runChildFirst(void (*func)()) {
+    return runDirectInternal((ptr_t)func, nullptr, nullptr, this);
+  }
+  /** Start fibre child-first: run immediately on current worker, caller continues later. */
+  template<typename T1>
+  Fibre* runChildFirst(void (*func)(T1*), T1* p1) {
+    return runDirectInternal((ptr_t)func, (ptr_t)p1, nullptr, this);
+  }
+  /** Start fibre child-first with pthread-type run function. */
+  template<typename T1>
+  Fibre* runChildFirst(void* (*func)(T1*), T1* p1) {
+    return runDirectInternal((ptr_t)func, (ptr_t)p1, nullptr, this);
+  }
+
   /** Sleep. */
   static void nanosleep(const Time& t) {
     sleepFred(t);
@@ -264,8 +443,16 @@ public:
   }
 
   // context switching interface
+  // NOTE: copying stacks on switch (shared-stack mode) is not supported: blocking
+  // primitives (BlockingQueue, TimerQueue, SynchronizedFlag) link nodes on the
+  // suspended fibre's stack into shared structures that other workers traverse.
   void deactivate(Fibre& next, _friend<Fred>) {
+#if TESTING_LAZY_FPFLAGS
+    if (fpSave) fp.save();
+    if (next.fp != fp) next.fp.restore(); // current flags are 'fp'
+#else
     fp.save();
+#endif
 #ifdef SPLIT_STACK
     __splitstack_getcontext(splitStackContext);
     __splitstack_setcontext(next.splitStackContext);
@@ -274,7 +461,9 @@ public:
 #endif
   }
   void activate(_friend<Fred>) {
+#if !TESTING_LAZY_FPFLAGS
     fp.restore();
+#endif
   }
 };
 
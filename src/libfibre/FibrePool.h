@@ -0,0 +1,161 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef _FibrePool_h_
+#define _FibrePool_h_ 1
+
+#include "libfibre/Fibre.h"
+
+/** A FibrePool keeps finished fibres (object and stack) parked for reuse.
+    A pool fibre runs one job after another without any heap allocation,
+    stack setup, or debug registration between jobs. It terminates only
+    when 'idleMax' fibres are parked already or the pool is destroyed.
+    Jobs must return normally, i.e., not use Fibre::exit(). Each cluster
+    keeps a pool for detached fibre_create() (see Cluster::getDetachedPool).
+    Fibre::run()/detach() cannot recycle fibres: the Fibre object belongs
+    to the caller, who may still reference it after the fibre finishes,
+    and detach() may be called only after the fibre has started. */
+class FibrePool {
+  class PoolFibre : public Fibre {
+    friend class FibrePool;
+    FibrePool&  pool;
+    PoolFibre*  next;
+    funcvoid1_t func;
+    ptr_t       arg;
+    PoolFibre(FibrePool& p, funcvoid1_t f, ptr_t a)
+    : Fibre(Context::CurrProcessor().getScheduler(), p.stackSize), pool(p), next(nullptr), func(f), arg(a) {}
+    static void main(PoolFibre* This) {
+      do {
+        This->func(This->arg);
+        This->clearSpecific();
+      } while (This->pool.park(*This));
+    }
+  };
+
+  WorkerLock        lock;
+  PoolFibre*        idle;      // stack of parked fibres
+  PoolFibre*        retired;   // stack of terminating fibres, awaiting join
+  size_t            idleCount;
+  size_t            liveCount; // fibres not retired
+  size_t            idleMax;
+  size_t            stackSize;
+  bool              closing;
+  SynchronizedFlag  drained;
+
+  // called by pool fibre after job: returns false, if fibre should terminate
+  bool park(PoolFibre& f) {
+    lock.acquire();
+    if (closing || idleCount >= idleMax) {
+      f.next = retired;
+      retired = &f;
+      liveCount -= 1;
+      if (closing && liveCount == 0) drained.post();
+      lock.release();
+      return false;
+    }
+    f.next = idle;
+    idle = &f;
+    idleCount += 1;
+    lock.release();
+    Suspender::suspend(f); // early resume from run() handled by Fred::runState
+    return f.func != nullptr;
+  }
+
+  static void reap(PoolFibre* f) {
+    while (f) {
+      PoolFibre* n = f->next;
+      delete f;            // join: fibre might still be terminating
+      f = n;
+    }
+  }
+
+public:
+  static const size_t DetachedMax = 1024; // parked fibres per cluster for fibre_create()
+
+  /** Constructor. New pool fibres are created on the caller's cluster. */
+  FibrePool(size_t idleMax = limit<size_t>(), size_t stackSize = Fibre::DefaultStackSize)
+  : idle(nullptr), retired(nullptr), idleCount(0), liveCount(0), idleMax(idleMax), stackSize(stackSize), closing(false) {}
+
+  /** Destructor: terminates parked fibres and waits for running jobs. */
+  ~FibrePool() {
+    lock.acquire();
+    closing = true;
+    PoolFibre* list = idle;
+    idle = nullptr;
+    liveCount -= idleCount;
+    idleCount = 0;
+    for (PoolFibre* f = list; f; ) {
+      PoolFibre* n = f->next;
+      f->next = retired;
+      retired = f;
+      f->func = nullptr;
+      f->resume();
+      f = n;
+    }
+    if (liveCount > 0) drained.wait(lock);
+    PoolFibre* r = retired;
+    retired = nullptr;
+    lock.release();
+    reap(r);
+  }
+
+  /** Run 'func(arg)' on a parked fibre, or on a new fibre, if none is parked.
+      Returns true, if a parked fibre has been reused. 'fibre' is set to the
+      fibre running the job; it is reused for other jobs after 'func' returns. */
+  bool run(funcvoid1_t func, ptr_t arg, Fibre*& fibre) {
+    lock.acquire();
+    PoolFibre* f = idle;
+    if (f) {
+      idle = f->next;
+      idleCount -= 1;
+    } else {
+      liveCount += 1;
+    }
+    PoolFibre* r = retired;
+    retired = nullptr;
+    lock.release();
+    if (f) {
+      f->func = func;
+      f->arg = arg;
+      fibre = f;
+      f->resume();
+    } else {
+      PoolFibre* nf = new PoolFibre(*this, func, arg);
+      fibre = nf;
+      nf->run(PoolFibre::main, nf);
+    }
+    reap(r);
+    return f != nullptr;
+  }
+
+  /** Run 'func(arg)' on a parked fibre, or on a new fibre, if none is parked.
+      Returns true, if a parked fibre has been reused. */
+  bool run(funcvoid1_t func, ptr_t arg) {
+    Fibre* fibre;
+    return run(func, arg, fibre);
+  }
+
+  /** Run 'func(arg)' on a parked fibre, or on a new fibre, if none is parked. */
+  template<typename T1>
+  bool run(void (*func)(T1*), T1* arg) {
+    return run((funcvoid1_t)func, (ptr_t)arg);
+  }
+
+  /** Number of currently parked fibres. */
+  size_t getIdleCount() const { return idleCount; }
+};
+
+#endif /* _FibrePool_h_ */
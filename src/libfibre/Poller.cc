@@ -41,6 +41,18 @@ inline Fred* BasePoller::notifyOne(EventType& ev) {
   } else if (ev.filter == EVFILT_USER) {
     userEvent.V();
   }
+#elif TESTING_EVENTPOLL_COMBINED
+  // both directions in one registration: notify each (returns input fred, if any)
+  Fred* next = nullptr;
+  if (ev.events & (EPOLLIN | EPOLLPRI | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+    next = eventScope.unblock<true,Enqueue>(ev.data.fd, _friend<BasePoller>());
+  }
+  if (ev.events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+    Fred* out = eventScope.unblock<false,Enqueue>(ev.data.fd, _friend<BasePoller>());
+    if (!next) next = out;
+    else if (!Enqueue && out) out->resume(); // only one fred returned
+  }
+  return next;
 #else // __linux__ below
   if (ev.events & (EPOLLIN | EPOLLPRI | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
     return eventScope.unblock<true,Enqueue>(ev.data.fd, _friend<BasePoller>());
@@ -53,9 +65,43 @@ inline Fred* BasePoller::notifyOne(EventType& ev) {
 }
 
 inline void BasePoller::notifyAll(int evcnt) {
+#if TESTING_BATCH_RESUME
+  ResumeBatch batch;
+  for (int e = 0; e < evcnt; e += 1) {
+    Fred* f = notifyOne<false>(events[e]);
+    if (f) batch.add(*f);
+  }
+#else
   for (int e = 0; e < evcnt; e += 1) notifyOne(events[e]);
+#endif
+}
+
+#if TESTING_EVENTPOLL_BATCHCTL
+inline void BasePoller::applyRearm() {
+  rearmLock.acquire();
+  rearmBatch.swap(rearmQueue);
+  rearmApplying = !rearmBatch.empty();
+  rearmLock.release();
+  if (rearmBatch.empty()) return;
+  stats->rearms.count(rearmBatch.size());
+  for (const Rearm& r : rearmBatch) setupFD(r.fd, Modify, r.dir, r.var);
+  rearmBatch.clear();
+  __atomic_store_n(&rearmApplying, false, __ATOMIC_RELEASE);
 }
 
+inline bool BasePoller::deactivateRearm() { // false: requests pending
+  ScopedLock<BinaryLock<>> sl(rearmLock);
+  if (!rearmQueue.empty()) return false;
+  rearmActive = false;
+  return true;
+}
+
+inline void BasePoller::activateRearm() {
+  ScopedLock<BinaryLock<>> sl(rearmLock);
+  rearmActive = true;
+}
+#endif
+
 #if TESTING_WORKER_POLLER
 template<WorkerPoller::PollType PT>
 size_t WorkerPoller::internalPoll() {
@@ -86,25 +132,85 @@ void WorkerPoller::suspend(_friend<Cluster>) {
 }
 #endif
 
+#if TESTING_POLLER_ADAPTIVE
+// load: moving average over 8 polls, grow set at 32 events per poll (on average),
+// shrink after 64 blocking polls with less than one event per poll (on average)
+static const size_t LoadShift   =  3;
+static const size_t GrowLoad    = 32 << LoadShift;
+static const size_t ShrinkLoad  =  1 << LoadShift;
+static const size_t ShrinkIdle  = 64;
+
+inline bool PollerFibre::adaptCount(bool grow) {
+  if (!activeCount) return false;
+  size_t c = *activeCount;
+  if (grow ? c >= activeMax : c <= 1) return false;
+  if (!__atomic_compare_exchange_n(activeCount, &c, grow ? c + 1 : c - 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) return false;
+  DBG::outl(DBG::Level::Polling, "Poller ", FmtHex(this), grow ? " grows" : " shrinks", " poller set to ", grow ? c + 1 : c - 1);
+  (grow ? stats->grows : stats->shrinks).count();
+  return true;
+}
+
+inline void PollerFibre::adaptLoad(int evcnt) {
+  loadAvg = loadAvg - (loadAvg >> LoadShift) + evcnt;
+  if (loadAvg >= GrowLoad) {
+    if (adaptCount(true)) loadAvg = 0;
+    idleBlocks = 0;
+  }
+}
+#endif
+
 inline void PollerFibre::pollLoop() {
 #if TESTING_POLLER_FIBRE_SPIN
   static const size_t SpinMax = TESTING_POLLER_FIBRE_SPIN;
+#elif TESTING_POLLER_ADAPTIVE
+  static const size_t SpinMax = 1024;
 #else
   static const size_t SpinMax = 1;
 #endif
   size_t spin = 1;
   bool blockingStats = false;
+#if TESTING_EVENTPOLL_BATCHCTL
+  activateRearm();
+#endif
   while (!pollTerminate) {
+#if TESTING_EVENTPOLL_BATCHCTL
+    applyRearm();
+#endif
     int evcnt = doPoll<false>(blockingStats);
+#if TESTING_POLLER_ADAPTIVE
+    adaptLoad(evcnt);
+#endif
     if fastpath(evcnt > 0) {
       notifyAll(evcnt);
+#if TESTING_POLLER_ADAPTIVE
+      // events arrived while spinning: spin longer next time
+      if (spin > 1 && spinLimit < SpinMax) spinLimit += spinLimit;
+#endif
       spin = 1;
       blockingStats = false;
       Fibre::yieldGlobal();
+#if TESTING_POLLER_ADAPTIVE
+    } else if (spin >= spinLimit) {
+#else
     } else if (spin >= SpinMax) {
+#endif
+#if TESTING_EVENTPOLL_BATCHCTL
+      if (!deactivateRearm()) continue;     // apply pending requests first
+#endif
+#if TESTING_POLLER_ADAPTIVE
+      // spin limit reached without events: block sooner next time
+      if (spinLimit > 1) spinLimit >>= 1;
+      if (loadAvg < ShrinkLoad && ++idleBlocks >= ShrinkIdle) {
+        adaptCount(false);
+        idleBlocks = 0;
+      }
+#endif
       spin = 1;
       blockingStats = true;
       eventScope.blockPollFD(pollFD, _friend<PollerFibre>());
+#if TESTING_EVENTPOLL_BATCHCTL
+      activateRearm();
+#endif
     } else {
       spin += 1;
       blockingStats = false;
@@ -120,6 +226,13 @@ void PollerFibre::pollLoopSetup(PollerFibre* This) {
 
 PollerFibre::PollerFibre(EventScope& es, cptr_t parent, const char* n, _friend<Cluster> fc)
 : BasePoller(es, parent, n) {
+#if TESTING_POLLER_ADAPTIVE
+  spinLimit = 1;
+  loadAvg = 0;
+  idleBlocks = 0;
+  activeCount = nullptr;
+  activeMax = 1;
+#endif
   pollFibre = new Fibre(Context::CurrProcessor(), fc);
   pollFibre->setName("s:Poller");
 }
@@ -24,6 +24,9 @@ class Cluster;
 
 #include <pthread.h>
 #include <unistd.h>      // close
+#if TESTING_EVENTPOLL_BATCHCTL
+#include <vector>
+#endif
 #if defined(__FreeBSD__)
 #include <sys/event.h>
 #else // __linux__ below
@@ -49,7 +52,11 @@ struct Poller {
   enum Direction : ssize_t { Input = EPOLLIN | EPOLLPRI | EPOLLRDHUP, Output = EPOLLOUT };
   enum Variant   : ssize_t { Level = 0, Edge = EPOLLET, Oneshot = EPOLLONESHOT, OnDemand = EPOLLONESHOT | EPOLLONDEMAND };
 #endif
+#if TESTING_LOCKFREE_FDSYNC
+  typedef ReadySemaphore SyncSem;
+#else
   typedef LockedSemaphore<WorkerLock,true> SyncSem;
+#endif
 };
 
 class BasePoller : public Poller {
@@ -64,6 +71,20 @@ protected:
   EventScope&   eventScope;
   volatile bool pollTerminate;
 
+#if TESTING_EVENTPOLL_BATCHCTL
+  // re-arm requests deferred while poller fibre is active, applied before next poll
+  struct Rearm { int fd; Direction dir; Variant var; };
+  BinaryLock<>       rearmLock;
+  std::vector<Rearm> rearmQueue;
+  std::vector<Rearm> rearmBatch;
+  bool               rearmActive;
+  bool volatile      rearmApplying;
+
+  inline void applyRearm();
+  inline bool deactivateRearm();
+  inline void activateRearm();
+#endif
+
   FredStats::PollerStats* stats;
 
   template<bool Blocking>
@@ -76,6 +97,10 @@ protected:
 
 public:
   BasePoller(EventScope& es, cptr_t parent, const char* n = "BasePoller") : eventScope(es), pollTerminate(false) {
+#if TESTING_EVENTPOLL_BATCHCTL
+    rearmActive = false;
+    rearmApplying = false;
+#endif
     stats = new FredStats::PollerStats(this, parent, n);
 #if defined(__FreeBSD__)
     pollFD = SYSCALLIO(kqueue());
@@ -103,6 +128,36 @@ public:
     SYSCALL(epoll_ctl(pollFD, op, fd, op == Remove ? nullptr : &ev));
 #endif
   }
+
+  void rearmFD(int fd, Direction dir, Variant var) {
+#if TESTING_EVENTPOLL_BATCHCTL
+    rearmLock.acquire();
+    if (rearmActive) {
+      rearmQueue.push_back({fd, dir, var});
+      rearmLock.release();
+      return;
+    }
+    rearmLock.release();
+#endif
+    setupFD(fd, Modify, dir, var);
+  }
+
+#if TESTING_EVENTPOLL_BATCHCTL
+  // fd closing: drop deferred re-arms and wait for a batch in progress
+  void cancelRearm(int fd) {
+    rearmLock.acquire();
+    for (size_t i = 0; i < rearmQueue.size();) {
+      if (rearmQueue[i].fd == fd) {
+        rearmQueue[i] = rearmQueue.back();
+        rearmQueue.pop_back();
+      } else {
+        i += 1;
+      }
+    }
+    rearmLock.release();
+    while (__atomic_load_n(&rearmApplying, __ATOMIC_ACQUIRE)) Fred::yield();
+  }
+#endif
 };
 
 #if TESTING_WORKER_POLLER
@@ -144,6 +199,15 @@ public:
 
 class PollerFibre : public BasePoller {
   Fibre* pollFibre;
+#if TESTING_POLLER_ADAPTIVE
+  size_t           spinLimit;   // current spin limit, adapted to event arrivals
+  size_t           loadAvg;     // moving average of events per poll (scaled)
+  size_t           idleBlocks;  // blocking polls at low load since last adaptation
+  size_t volatile* activeCount; // adaptive poller set (nullptr: fixed)
+  size_t           activeMax;
+  inline void adaptLoad(int evcnt);
+  inline bool adaptCount(bool grow);
+#endif
   inline void pollLoop();
   static void pollLoopSetup(PollerFibre*);
 
@@ -151,6 +215,12 @@ public:
   PollerFibre(EventScope&, cptr_t parent, const char* n, _friend<Cluster>);
   ~PollerFibre();
   void start();
+#if TESTING_POLLER_ADAPTIVE
+  void setAdaptive(size_t volatile& active, size_t max, _friend<Cluster>) {
+    activeCount = &active;
+    activeMax = max;
+  }
+#endif
 };
 
 class BaseThreadPoller : public BasePoller {
@@ -0,0 +1,225 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "libfibre/StackPool.h"
+#include "runtime/Debug.h"
+#if TESTING_STACK_NUMA
+#include "libfibre/CpuTopology.h"
+#endif
+
+#include <sys/mman.h> // mmap, munmap, mprotect, madvise
+#if TESTING_STACK_NUMA && defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if TESTING_STACK_ARENA && defined(__linux__) && !defined(MADV_GUARD_INSTALL)
+#define MADV_GUARD_INSTALL 102
+#endif
+
+#if TESTING_STACK_NUMA && defined(__linux__) && !defined(MPOL_PREFERRED)
+#define MPOL_PREFERRED 1
+#endif
+
+thread_local StackPool::Local StackPool::local;
+StackPool::Global StackPool::global[MaxNodes][NumClasses];
+
+size_t StackPool::currentNode() {
+#if TESTING_STACK_NUMA
+  CpuTopology::init();
+  size_t n = CpuTopology::node(CpuTopology::currentCpu());
+  return n == CpuTopology::Unknown ? 0 : n;
+#else
+  return 0;
+#endif
+}
+
+#if TESTING_STACK_ARENA
+StackPool::Arena StackPool::arena[MaxNodes];
+bool StackPool::arenaEnabled = false;
+
+// decide once before any stacks are allocated: without MADV_GUARD_INSTALL,
+// guard pages would need mprotect, splitting the arena mapping per stack
+void StackPool::init() {
+#if defined(MADV_GUARD_INSTALL)
+  ptr_t ptr = mmap(0, 2 * _lfPagesize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_NORESERVE, -1, 0);
+  RASSERT0(ptr != MAP_FAILED);
+  arenaEnabled = madvise(ptr, _lfPagesize, MADV_GUARD_INSTALL) == 0;
+  SYSCALL(munmap(ptr, 2 * _lfPagesize));
+#endif
+  if (!arenaEnabled) DBG::outl(DBG::Level::Basic, "StackPool: MADV_GUARD_INSTALL not supported - stack arena disabled");
+}
+
+vaddr StackPool::arenaRegion(size_t node) {
+#if TESTING_STACK_HUGEPAGE
+  size_t len = ArenaSize + HugePageSize;   // reserve extra for alignment
+#else
+  size_t len = ArenaSize;
+#endif
+  ptr_t ptr = mmap(0, len, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_NORESERVE, -1, 0);
+  RASSERT0(ptr != MAP_FAILED);
+#if TESTING_STACK_HUGEPAGE
+  ptr = ptr_t(align_up(vaddr(ptr), HugePageSize));
+#if defined(MADV_HUGEPAGE)
+  madvise(ptr, ArenaSize, MADV_HUGEPAGE);  // best effort
+#endif
+#endif
+#if TESTING_STACK_NUMA && defined(__linux__)
+  if (node < bitsize<unsigned long>()) {
+    unsigned long mask = 1ul << node;
+    syscall(SYS_mbind, ptr, ArenaSize, MPOL_PREFERRED, &mask, bitsize<unsigned long>(), 0); // best effort
+  }
+#else
+  (void)node;
+#endif
+  return vaddr(ptr);
+}
+
+vaddr StackPool::arenaStack(size_t size, size_t guard) {
+#if TESTING_STACK_HUGEPAGE
+  // stack starts at huge page boundary, guard page at the end of the preceding
+  // huge page, which is otherwise unused: only that page is split by the guard
+  RASSERT(guard <= HugePageSize, guard);
+  size_t total = HugePageSize + align_up(size, HugePageSize);
+  size_t offset = HugePageSize - guard;
+#else
+  size_t total = size + guard;
+  size_t offset = 0;
+#endif
+  size_t node = currentNode();
+  Arena& a = arena[node % MaxNodes];
+  a.lock.acquire();
+  if (a.next + total > a.end) {         // remainder of previous region is abandoned
+    a.next = arenaRegion(node);
+    a.end = a.next + ArenaSize;
+  }
+  vaddr bottom = a.next + offset;
+  a.next += total;
+  a.lock.release();
+  SYSCALL(madvise(ptr_t(bottom), guard, MADV_GUARD_INSTALL)); // checked in init()
+  return bottom;
+}
+#endif
+
+vaddr StackPool::mapStack(size_t size, size_t guard) {
+  // check that requested size/guard is a multiple of page size
+  RASSERT(aligned(size, _lfPagesize), size);
+  RASSERT(aligned(guard, _lfPagesize), size);
+  // add PROT_EXEC here to make stack executable (needed for nested C functions)
+  ptr_t ptr = mmap(0, size + guard, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON, -1, 0);
+  RASSERT0(ptr != MAP_FAILED);
+  // set up protection page
+  if (guard) SYSCALL(mprotect(ptr, guard, PROT_NONE));
+  return vaddr(ptr);
+}
+
+void StackPool::unmapStack(vaddr bottom, size_t total) {
+  SYSCALL(munmap(ptr_t(bottom), total));
+}
+
+void StackPool::trimStack(vaddr bottom, size_t total, size_t guard) {
+#if TESTING_STACK_HUGEPAGE
+  (void)bottom; (void)total; (void)guard;      // no trimming: would split huge page
+#else
+  size_t len = total - guard - _lfPagesize;    // keep top page with link
+  if (len == 0) return;
+#if defined(MADV_FREE)
+  if (madvise(ptr_t(bottom + guard), len, MADV_FREE) == 0) return;
+#endif
+  SYSCALL(madvise(ptr_t(bottom + guard), len, MADV_DONTNEED));
+#endif
+}
+
+// move up to half of LocalMax stacks from global pool to thread cache
+void StackPool::refill(size_t c, size_t total) {
+  Global& g = global[currentNode() % MaxNodes][c];
+  if (!g.count) return;
+  ScopedLock<BinaryLock<>> sl(g.lock);
+  for (size_t i = 0; i < LocalMax / 2 && g.count; i += 1) {
+    vaddr s = g.head;
+    g.head = link(s, total);
+    g.count -= 1;
+    link(s, total) = local.head[c];
+    local.head[c] = s;
+    local.count[c] += 1;
+  }
+}
+
+// move half of LocalMax stacks from thread cache to global pool, unmap if pool is full
+void StackPool::spill(size_t c, size_t total) {
+  vaddr first = 0;
+  size_t count;
+  for (count = 0; count < LocalMax / 2 && local.count[c]; count += 1) {
+    vaddr s = local.head[c];
+    local.head[c] = link(s, total);
+    local.count[c] -= 1;
+    trimStack(s, total, CacheGuard);
+    link(s, total) = first;
+    first = s;
+  }
+  Global& g = global[currentNode() % MaxNodes][c];
+  g.lock.acquire();
+#if TESTING_STACK_ARENA
+  while (count > 0 && (arenaEnabled || g.count < GlobalMax)) { // arena stacks are never unmapped
+#else
+  while (count > 0 && g.count < GlobalMax) {
+#endif
+    vaddr s = first;
+    first = link(s, total);
+    count -= 1;
+    link(s, total) = g.head;
+    g.head = s;
+    g.count += 1;
+  }
+  g.lock.release();
+  while (count > 0) {
+    vaddr s = first;
+    first = link(s, total);
+    count -= 1;
+    unmapStack(s, total);
+  }
+}
+
+vaddr StackPool::alloc(size_t& size, size_t guard) {
+  size_t c = sizeClass(size, guard);
+  if (c >= NumClasses) return mapStack(size, guard);
+  size = classSize(c);
+  size_t total = size + guard;
+  if (!local.count[c]) refill(c, total);
+#if TESTING_STACK_ARENA
+  if (!local.count[c]) return arenaEnabled ? arenaStack(size, guard) : mapStack(size, guard);
+#else
+  if (!local.count[c]) return mapStack(size, guard);
+#endif
+  vaddr s = local.head[c];
+  local.head[c] = link(s, total);
+  local.count[c] -= 1;
+  return s;
+}
+
+void StackPool::free(vaddr bottom, size_t size, size_t guard) {
+  size_t c = sizeClass(size, guard);
+  if (c >= NumClasses) {
+    unmapStack(bottom, size + guard);
+    return;
+  }
+  RASSERT(size == classSize(c), size);
+  size_t total = size + guard;
+  if (local.count[c] >= LocalMax) spill(c, total);
+  link(bottom, total) = local.head[c];
+  local.head[c] = bottom;
+  local.count[c] += 1;
+}
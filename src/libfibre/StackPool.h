@@ -0,0 +1,111 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef _StackPool_h_
+#define _StackPool_h_ 1
+
+#include "runtime-glue/RuntimeLock.h"
+
+extern size_t _lfPagesize; // Bootstrap.cc
+
+// Fibre stack allocation with per-thread cache and global overflow pool.
+// Stacks are cached per power-of-2 size class (usable size, default guard only).
+// Cached stacks keep their mapping and guard page. Stacks spilling from the
+// thread cache into the global pool are trimmed (MADV_FREE) except for the
+// top page, which holds the free-list link. Other sizes are mapped directly.
+// TESTING_STACK_ARENA: cached stacks are carved from large reserved regions
+// and never unmapped. Guard pages use MADV_GUARD_INSTALL (Linux 6.13+), which
+// does not split the mapping; on older kernels, init() disables the arena.
+// TESTING_STACK_NUMA: arenas and global pools per NUMA node of the calling
+// thread; arena regions are bound to their node (MPOL_PREFERRED).
+// TESTING_STACK_HUGEPAGE: arena regions are 2MB-aligned and use transparent
+// huge pages. Each stack starts on a huge page boundary, with its guard page
+// at the end of a preceding, otherwise unused huge page, so only that page is
+// split. Cached stacks are not trimmed. Touched stack memory is fully backed.
+class StackPool {
+public:
+  static const size_t CacheGuard   = 4096;  // Fibre::DefaultStackGuard
+  static const size_t MinClassBits =   14;  // 16KB
+  static const size_t MaxClassBits =   20;  // 1MB
+  static const size_t NumClasses   = MaxClassBits - MinClassBits + 1;
+  static const size_t LocalMax     =   16;  // per thread and size class
+  static const size_t GlobalMax    = 1024;  // per size class (not used with arena)
+#if TESTING_STACK_ARENA
+  static const size_t ArenaSize    = pow2<size_t>(30); // reservation granularity
+#endif
+#if TESTING_STACK_NUMA
+  static const size_t MaxNodes     =   16;  // higher node ids share pools
+#else
+  static const size_t MaxNodes     =    1;
+#endif
+#if TESTING_STACK_HUGEPAGE
+  static const size_t HugePageSize = pow2<size_t>(21);
+#endif
+
+private:
+  struct Local {
+    vaddr  head[NumClasses];
+    size_t count[NumClasses];
+  };
+  struct Global {
+    BinaryLock<> lock;
+    vaddr        head;
+    size_t       count;
+  };
+  static thread_local Local local;
+  static Global global[MaxNodes][NumClasses];
+#if TESTING_STACK_ARENA
+  struct Arena {
+    BinaryLock<> lock;
+    vaddr        next;
+    vaddr        end;
+  };
+  static Arena arena[MaxNodes];
+  static bool  arenaEnabled;
+  static vaddr arenaRegion(size_t node);
+  static vaddr arenaStack(size_t size, size_t guard);
+#endif
+
+  static size_t currentNode();
+
+  static size_t sizeClass(size_t size, size_t guard) {
+    if (guard != CacheGuard || size < pow2<size_t>(MinClassBits) || size > pow2<size_t>(MaxClassBits)) return NumClasses;
+    return ceilinglog2(size) - MinClassBits;
+  }
+  static size_t classSize(size_t c) { return pow2<size_t>(c + MinClassBits); }
+  static vaddr& link(vaddr bottom, size_t total) { return *(vaddr*)(bottom + total - sizeof(vaddr)); }
+
+  static vaddr mapStack(size_t size, size_t guard);
+  static void  unmapStack(vaddr bottom, size_t total);
+  static void  trimStack(vaddr bottom, size_t total, size_t guard);
+  static void  refill(size_t c, size_t total);
+  static void  spill(size_t c, size_t total);
+
+public:
+#if TESTING_STACK_ARENA
+  static void  init();
+#endif
+  // stack of this size available in thread cache
+  static bool  cached(size_t size, size_t guard) {
+    size_t c = sizeClass(size, guard);
+    return c < NumClasses && local.count[c];
+  }
+  // returns bottom of mapping (including guard), 'size' might be rounded up
+  static vaddr alloc(size_t& size, size_t guard);
+  static void  free(vaddr bottom, size_t size, size_t guard);
+};
+
+#endif /* _StackPool_h_ */
@@ -0,0 +1,50 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#include "libfibre/StackProfile.h"
+#include "libfibre/Fibre.h"
+
+#if TESTING_STACK_PROFILE
+
+WorkerLock StackProfile::lock;
+std::map<ptr_t,StackProfile::Entry>* StackProfile::profile = nullptr;
+thread_local size_t StackProfile::tick = 0;
+
+void StackProfile::record(ptr_t func, vaddr low, vaddr high) {
+  uintptr_t* p = (uintptr_t*)low;
+  while (p < (uintptr_t*)high && *p == Canary) p += 1;
+  size_t used = high - vaddr(p);
+  ScopedLock<WorkerLock> sl(lock);
+  if (!profile) profile = new std::map<ptr_t,Entry>;
+  Entry& e = (*profile)[func];
+  if (!e.stats) e.stats = new FredStats::StackStats(func, nullptr);
+  e.stats->count(used);
+  if (used > e.maximum) e.maximum = used;
+  e.samples += 1;
+}
+
+size_t StackProfile::suggest(ptr_t func, size_t size) {
+  if (size != Fibre::DefaultStackSize) return size; // explicit size
+  ScopedLock<WorkerLock> sl(lock);
+  if (!profile) return size;
+  auto it = profile->find(func);
+  if (it == profile->end() || it->second.samples < MinSamples) return size;
+  size_t s = pow2<size_t>(ceilinglog2(2 * it->second.maximum));
+  if (s < MinSize) s = MinSize;
+  return s < size ? s : size;
+}
+
+#endif /* TESTING_STACK_PROFILE */
@@ -0,0 +1,59 @@
+/******************************************************************************
+    Copyright (C) Martin Karsten 2015-2023
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef _StackProfile_h_
+#define _StackProfile_h_ 1
+
+#include "runtime/Stats.h"
+#include "runtime-glue/RuntimeLock.h"
+
+#include <map>
+
+// Stack high-water profiling: every SampleRate-th new stack (per thread) is
+// filled with a canary pattern. When a sampled fibre terminates, the lowest
+// overwritten word determines its stack usage, which is recorded per entry
+// function and reported via FredStats.
+// TESTING_STACK_AUTOSIZE: default-sized stacks are shrunk to twice the
+// observed maximum for the entry function (rounded up to a power of 2).
+// Only lazily bound stacks are resized, or eager stacks if the stack cache
+// holds a replacement of the suggested size.
+class StackProfile {
+public:
+  static const uintptr_t Canary     = 0xCA7CA7CA7CA7CA7C;
+  static const size_t    MinSize    = 16384;
+  static const size_t    MinSamples =    16;
+  static const size_t    SampleRate =    16;
+
+private:
+  struct Entry {
+    size_t maximum;
+    size_t samples;
+    FredStats::StackStats* stats;
+  };
+  static WorkerLock lock;
+  static std::map<ptr_t,Entry>* profile;
+  static thread_local size_t tick;
+
+public:
+  static bool sample() { return tick++ % SampleRate == 0; }
+  static void fill(vaddr low, vaddr high) {
+    for (uintptr_t* p = (uintptr_t*)low; p < (uintptr_t*)high; p += 1) *p = Canary;
+  }
+  static void   record(ptr_t func, vaddr low, vaddr high);
+  static size_t suggest(ptr_t func, size_t size);
+};
+
+#endif /* _StackProfile_h_ */
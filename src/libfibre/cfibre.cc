@@ -160,6 +160,14 @@ extern "C" int cfibre_attr_getdetachstate(const cfibre_attr_t *attr, int *detach
   return fibre_attr_getdetachstate(*attr, detachstate);
 }
 
+extern "C" int cfibre_attr_setchildfirst(cfibre_attr_t *attr, int childfirst) {
+  return fibre_attr_setchildfirst(*attr, childfirst);
+}
+
+extern "C" int cfibre_attr_getchildfirst(const cfibre_attr_t *attr, int *childfirst) {
+  return fibre_attr_getchildfirst(*attr, childfirst);
+}
+
 extern "C" int cfibre_create(cfibre_t *thread, const cfibre_attr_t *attr, void *(*start_routine) (void *), void *arg) {
   if (attr) {
     return fibre_create((fibre_t*)thread, (fibre_attr_t*)*attr, start_routine, arg);
@@ -132,6 +132,8 @@ int cfibre_attr_setaffinity(cfibre_attr_t *attr, int affinity);
 int cfibre_attr_getaffinity(const cfibre_attr_t *attr, int *affinity);
 int cfibre_attr_setdetachstate(cfibre_attr_t *attr, int detachstate);
 int cfibre_attr_getdetachstate(const cfibre_attr_t *attr, int *detachstate);
+int cfibre_attr_setchildfirst(cfibre_attr_t *attr, int childfirst);
+int cfibre_attr_getchildfirst(const cfibre_attr_t *attr, int *childfirst);
 
 int cfibre_create(cfibre_t *thread, const cfibre_attr_t *attr, void *(*start_routine) (void *), void *arg);
 int cfibre_join(cfibre_t thread, void **retval);
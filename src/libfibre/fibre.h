@@ -24,6 +24,7 @@
 #endif
 
 #include "libfibre/EventScope.h" // EventScope.h pulls in everything else
+#include "libfibre/FibrePool.h"
 
 typedef Fibre*                    fibre_t;
 typedef FredCondition             fibre_cond_t;
@@ -48,6 +49,7 @@ struct fibre_attr_t {
   size_t priority;
   size_t affinity;
   bool detached;
+  bool childFirst;
   void init() {
     cluster = &Context::CurrCluster();
     stackSize = Fibre::DefaultStackSize;
@@ -55,6 +57,7 @@ struct fibre_attr_t {
     priority = Fibre::DefaultPriority;
     affinity = Fibre::DefaultAffinity;
     detached = false;
+    childFirst = false;
   }
 };
 
@@ -196,16 +199,42 @@ inline int fibre_attr_getdetachstate(const fibre_attr_t *attr, int *detachstate)
   return 0;
 }
 
+/** @brief Set child-first attribute for fibre creation: new fibre runs immediately, caller is requeued. */
+inline int fibre_attr_setchildfirst(fibre_attr_t *attr, int childfirst) {
+  attr->childFirst = childfirst;
+  return 0;
+}
+
+/** @brief Get child-first attribute for fibre creation. */
+inline int fibre_attr_getchildfirst(const fibre_attr_t *attr, int *childfirst) {
+  *childfirst = attr->childFirst;
+  return 0;
+}
+
 /** @brief Create and start fibre. (`pthread_create`) */
 inline int fibre_create(fibre_t *thread, const fibre_attr_t *attr, void *(*start_routine) (void *), void *arg) {
   Fibre* f;
   if (!attr) {
     f = new Fibre;
   } else {
+    // detached with default attributes: handle is invalid after exit (as with
+    // pthreads), so the fibre is parked for reuse instead of leaking its object;
+    // fibre_exit() ends the pool fibre without parking it
+    if (attr->detached && !attr->childFirst && attr->cluster == &Context::CurrCluster()
+      && attr->stackSize == Fibre::DefaultStackSize && attr->guardSize == Fibre::DefaultStackGuard
+      && attr->priority == Fibre::DefaultPriority && attr->affinity == Fibre::DefaultAffinity) {
+      attr->cluster->getDetachedPool().run((funcvoid1_t)(ptr_t)start_routine, arg, *thread);
+      return 0;
+    }
     f = new Fibre(*attr->cluster, attr->stackSize, attr->guardSize);
     f->setPriority(Fibre::Priority(attr->priority));
     f->setAffinity(attr->affinity);
     if (attr->detached) f->detach();
+    if (attr->childFirst) {
+      *thread = f;
+      f->runChildFirst(start_routine, arg);
+      return 0;
+    }
   }
   *thread = f->run(start_routine, arg);
   return 0;
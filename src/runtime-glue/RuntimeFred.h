@@ -43,6 +43,13 @@ inline void RuntimePostFredSwitch(Fred& newFred, _friend<Fred> fs) {
   newFibre.activate(fs);
 }
 
+#if TESTING_LAZY_STACK
+inline void RuntimeBindStack(Fred& fred, _friend<Fred> fs) {
+  Fibre& fibre = reinterpret_cast<Fibre&>(fred);
+  fibre.bindStack(fs);
+}
+#endif
+
 inline void RuntimeFredDestroy(Fred& prevFred, _friend<Fred> fs) {
   Fibre& prevFibre = reinterpret_cast<Fibre&>(prevFred);
   prevFibre.destroy(fs);
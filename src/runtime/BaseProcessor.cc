@@ -29,7 +29,31 @@ inline Fred* BaseProcessor::searchAll() {
 }
 
 inline Fred* BaseProcessor::searchLocal() {
+#if TESTING_RUN_NEXT
+  if (runNext && runNextCount < RunNextMax) {
+    Fred* f = __atomic_exchange_n(&runNext, nullptr, __ATOMIC_SEQ_CST);
+    if (f) {
+      runNextLength(-1);
+      DBG::outl(DBG::Level::Scheduling, "searchLocal: ", FmtHex(this), " next ", FmtHex(f));
+      runNextCount += 1;
+      stats->next.count();
+      return f;
+    }
+  }
+  runNextCount = 0;
+#endif
   Fred* f = readyQueue.dequeue();
+#if TESTING_RUN_NEXT
+  if (!f && runNext) {
+    f = __atomic_exchange_n(&runNext, nullptr, __ATOMIC_SEQ_CST);
+    if (f) {
+      runNextLength(-1);
+      DBG::outl(DBG::Level::Scheduling, "searchLocal: ", FmtHex(this), " next ", FmtHex(f));
+      stats->next.count();
+      return f;
+    }
+  }
+#endif
   if (f) {
     DBG::outl(DBG::Level::Scheduling, "searchLocal: ", FmtHex(this), ' ', FmtHex(f));
     stats->deq.count();
@@ -38,21 +62,90 @@ inline Fred* BaseProcessor::searchLocal() {
 }
 
 #if TESTING_LOADBALANCING
+inline Fred* BaseProcessor::trySteal(BaseProcessor& victim) {
+#if TESTING_STEAL_HALF
+  Fred* last = nullptr;
+  size_t count = 0;
+  Fred* f = victim.readyQueue.tryDequeueHalf(last, count, StealBatchMax);
+#else
+  Fred* f = victim.readyQueue.tryDequeue();
+#endif
+#if TESTING_RUN_NEXT
+  if (!f) f = victim.stealRunNext();
+#endif
+  if (f) {
+    DBG::outl(DBG::Level::Scheduling, "searchSteal: ", FmtHex(this), "<-", FmtHex(&victim), ' ', FmtHex(f));
+    if (f->checkAffinity(*this, _friend<BaseProcessor>())) stats->borrow.count();
+    else stats->steal.count();
+#if TESTING_STEAL_HALF
+    if (count > 1) {  // run first, move remaining freds to local queue
+      Fred* first = Fred::VNext<FredReadyLink>(*f);
+      Fred::VNext<FredReadyLink>(*f) = nullptr;
+      for (Fred* n = first;; n = Fred::VNext<FredReadyLink>(*n)) {
+        if (n->checkAffinity(*this, _friend<BaseProcessor>())) stats->borrow.count();
+        else stats->steal.count();
+        if (n == last) break;
+      }
+      readyQueue.enqueueBatch(*first, *last, count - 1);
+    }
+#endif
+    return f;
+  }
+  return nullptr;
+}
+
+#if TESTING_STEAL_TOPOLOGY
+// NOTE: cached victims assume that processors are not removed while stealing
+void BaseProcessor::stealGroup(size_t count) {
+  if (count != stealCount) {
+    delete [] stealVictims;
+    stealVictims = new BaseProcessor*[count];
+    stealCount = count;
+  }
+  cpu = RuntimeCurrentCpu();
+  size_t n = 0;
+  for (size_t level = 0; level < StealLevels; level += 1) {
+    stealBound[level] = n;
+    for (BaseProcessor* victim = ProcessorRing::next(*this); victim != this && n < count; victim = ProcessorRing::next(*victim)) {
+      if (RuntimeCpuDistance(cpu, victim->cpu) == level) stealVictims[n++] = victim;
+    }
+  }
+  stealBound[StealLevels] = n;
+  stealAge = 0;
+}
+
+inline Fred* BaseProcessor::searchSteal() {
+  size_t count = scheduler.getProcessorCount();
+  if (count <= 1) return nullptr;
+  if (count != stealCount || stealAge >= StealRefresh) stealGroup(count);
+  stealAge += 1;
+  for (size_t level = 0; level < StealLevels; level += 1) {
+    size_t first = stealBound[level];
+    size_t size = stealBound[level+1] - first;
+    if (size == 0) continue;
+    size_t r = stealRandom() % size;
+    for (size_t i = 0; i < size; i += 1) {
+      Fred* f = trySteal(*stealVictims[first + (r + i) % size]);
+      if (f) {
+        stealAge = StealRefresh;  // thread might have migrated: regroup at next search
+        return f;
+      }
+    }
+  }
+  return nullptr;
+}
+#else
 inline Fred* BaseProcessor::searchSteal() {
   BaseProcessor* victim = ProcessorRing::next(*this);
   for (;;) {
     if (victim == this) return nullptr;
-    Fred* f = victim->readyQueue.tryDequeue();
-    if (f) {
-      DBG::outl(DBG::Level::Scheduling, "searchSteal: ", FmtHex(this), "<-", FmtHex(victim), ' ', FmtHex(f));
-      if (f->checkAffinity(*this, _friend<BaseProcessor>())) stats->borrow.count();
-      else stats->steal.count();
-      return f;
-    }
+    Fred* f = trySteal(*victim);
+    if (f) return f;
     victim = ProcessorRing::next(*victim);
   }
 }
 #endif
+#endif
 
 inline Fred* BaseProcessor::scheduleBlocking() {
   for (;;) {
@@ -123,9 +216,18 @@ inline Fred& BaseProcessor::scheduleIdle() {
 #endif /* TESTING_LOADBALANCING && TESTING_GO_IDLEMANAGER */
 
 void BaseProcessor::idleLoop(Fred* initFred) {
+#if TESTING_STEAL_TOPOLOGY
+  cpu = RuntimeCurrentCpu();
+#endif
   if (initFred) Fred::idleYieldTo(*initFred, _friend<BaseProcessor>());
   for (;;) {
+#if TESTING_PLACEMENT_CHOICES
+    idling = true;
+    Fred& nextFred = scheduleIdle();
+    idling = false;
+#else
     Fred& nextFred = scheduleIdle();
+#endif
     Fred::idleYieldTo(nextFred, _friend<BaseProcessor>());
   }
 }
@@ -143,17 +245,27 @@ Fred& BaseProcessor::scheduleFull(_friend<Fred>) {
   return nextFred ? *nextFred : *idleFred;
 }
 
-void BaseProcessor::enqueueResume(Fred& f, BaseProcessor&proc, _friend<Fred>) {
+template<bool RunNext>
+inline void BaseProcessor::enqueueReady(Fred& f, BaseProcessor& proc) {
 #if TESTING_LOADBALANCING
 #if TESTING_GO_IDLEMANAGER
-  enqueueFred(f);
+  enqueueFred<true,RunNext>(f);
   scheduler.idleManager.unblock(&proc);
 #else
-  if (!scheduler.idleManager.addReadyFred(f, proc)) enqueueFred(f);
+  if (!scheduler.idleManager.addReadyFred(f, proc)) enqueueFred<true,RunNext>(f);
 #endif
 #else
   (void)proc;
-  enqueueFred(f);
+  enqueueFred<true,RunNext>(f);
   if (!readyCount.V()) haltSem.V(*this);
 #endif
 }
+
+void BaseProcessor::enqueueResume(Fred& f, BaseProcessor&proc, _friend<Fred>) {
+  enqueueReady<true>(f, proc);
+}
+
+// continuation of child-first start: not in runNext slot, so it can be stolen right away
+void BaseProcessor::enqueueParent(Fred& f, _friend<Fred>) {
+  enqueueReady<false>(f, *this);
+}
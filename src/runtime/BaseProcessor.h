@@ -22,14 +22,32 @@
 #include "runtime/Fred.h"
 #include "runtime/HaltSemaphore.h"
 #include "runtime/Stats.h"
+#include "runtime-glue/RuntimeContext.h"
 
 class BaseProcessor;
 class IdleManager;
+class ResumeBatch;
 class Scheduler;
 
+#if TESTING_STEAL_TOPOLOGY
+// current cpu (or any value >= cpu count) and distance level between cpus (< StealLevels)
+extern size_t RuntimeCurrentCpu();
+extern size_t RuntimeCpuDistance(size_t, size_t);
+#endif
+
 class ReadyQueue {
   WorkerLock readyLock;
   FredReadyQueue queue[Fred::NumPriority];
+#if TESTING_WORKSTEALING_DEQUE
+  // owner-only LIFO deque for locally resumed freds, 'queue' acts as inbox
+  static const size_t DequeSize = 256;
+  static const size_t DequeFairness = 61; // move deque to inbox every N dequeues
+  DequeChaseLev<Fred,DequeSize> deque;
+  size_t dequeTick;
+#endif
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+  volatile ssize_t length; // approximate number of queued freds
+#endif
 
   FredStats::ReadyQueueStats* stats;
 
@@ -41,12 +59,32 @@ class ReadyQueue {
     for (size_t p = 0; p < Fred::NumPriority; p += 1) {
       Fred* f = queue[p].pop();
       if (f) return f;
+#if TESTING_WORKSTEALING_DEQUE
+      if (!Try && p == Fred::DefaultPriority) {
+        f = deque.pop();
+        if (f) return f;
+      }
+#endif
     }
     if (Try) stats->queue.tryfail();
     else stats->queue.fail();
     return nullptr;
   }
 
+  void countAdd(size_t n = 1) {
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+    __atomic_add_fetch(&length, n, __ATOMIC_RELAXED);
+#endif
+    stats->queue.add(n);
+  }
+
+  void countRemove(size_t n = 1) {
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+    __atomic_sub_fetch(&length, n, __ATOMIC_RELAXED);
+#endif
+    stats->queue.remove(n);
+  }
+
   bool probe() {
     for (size_t p = 0; p < Fred::NumPriority; p += 1) {
       if (!queue[p].empty<true>()) return true;
@@ -55,37 +93,151 @@ class ReadyQueue {
   }
 
 public:
-  ReadyQueue(BaseProcessor& bp) { stats = new FredStats::ReadyQueueStats(this, &bp); }
+  ReadyQueue(BaseProcessor& bp) {
+#if TESTING_WORKSTEALING_DEQUE
+    dequeTick = 0;
+#endif
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+    length = 0;
+#endif
+    stats = new FredStats::ReadyQueueStats(this, &bp);
+  }
+
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+  size_t getLength() const {
+    ssize_t l = __atomic_load_n(&length, __ATOMIC_RELAXED);
+    return l > 0 ? l : 0;
+  }
+
+  // fred held outside of queue (runNext slot): counted in length, but not in stats
+  void countOutside(ssize_t n) {
+    __atomic_add_fetch(&length, n, __ATOMIC_RELAXED);
+  }
+#endif
 
+#if TESTING_WORKSTEALING_DEQUE
+  Fred* dequeue() {
+    Fred* f = nullptr;
+    dequeTick += 1;
+    if (dequeTick % DequeFairness == 0) {
+      // fairness: move deque to inbox, oldest first, so that waiting time is bounded
+      ScopedLock<WorkerLock> sl(readyLock);
+      for (Fred* d = deque.steal(); d; d = deque.steal()) queue[Fred::DefaultPriority].push(*d);
+      f = dequeueInternal();
+      if (f) countRemove();
+      return f;
+    }
+    if (queue[Fred::TopPriority].empty<true>()) f = deque.pop();
+    if (!f) {
+      if (probe()) {
+        ScopedLock<WorkerLock> sl(readyLock);
+        f = dequeueInternal();
+      } else {
+        f = deque.pop();
+        if (!f) stats->queue.fail();
+      }
+    }
+    if (f) countRemove();
+    return f;
+  }
+#else
   Fred* dequeue() {
 #if TESTING_LOADBALANCING
     ScopedLock<WorkerLock> sl(readyLock);
 #endif
     Fred* f = dequeueInternal();
-    stats->queue.remove((int)(bool)f);
+    if (f) countRemove();
     return f;
   }
+#endif
 
 #if TESTING_LOADBALANCING
   Fred* tryDequeue() {
+    Fred* f;
+#if TESTING_WORKSTEALING_DEQUE
+    f = deque.steal();
+    if (f) {
+      countRemove();
+      return f;
+    }
+#endif
     if (!probe()) return nullptr;
     if (!readyLock.tryAcquire()) return nullptr;
-    Fred* f = dequeueInternal<true>();
-    stats->queue.remove((int)(bool)f);
+    f = dequeueInternal<true>();
+    if (f) countRemove();
     readyLock.release();
     return f;
   }
 #endif
 
+#if TESTING_STEAL_HALF
+  // remove up to half of the queued freds (at most 'max') from one priority level
+  // returns chain linked via FredReadyLink, 'count' is set to its length
+  Fred* tryDequeueHalf(Fred*& last, size_t& count, size_t max) {
+    size_t l = getLength();
+    size_t n = (l > 1) ? (l + 1) / 2 : 1;
+    if (n > max) n = max;
+    Fred* first;
+#if TESTING_WORKSTEALING_DEQUE
+    first = deque.steal();
+    if (first) {
+      for (last = first, count = 1; count < n; count += 1) {
+        Fred* f = deque.steal();
+        if (!f) break;
+        Fred::VNext<FredReadyLink>(*last) = f;
+        last = f;
+      }
+      countRemove(count);
+      return first;
+    }
+#endif
+    if (!probe()) return nullptr;
+    if (!readyLock.tryAcquire()) return nullptr;
+    first = dequeueInternal<true>();
+    if (first) {
+      FredReadyQueue& q = queue[first->getPriority()];
+      for (last = first, count = 1; count < n; count += 1) {
+        Fred* f = q.pop();
+        if (!f) break;
+        Fred::VNext<FredReadyLink>(*last) = f;
+        last = f;
+      }
+      countRemove(count);
+    }
+    readyLock.release();
+    return first;
+  }
+#endif
+
   void enqueue(Fred& f) {
     RASSERT(f.getPriority() < Fred::NumPriority, f.getPriority());
 #if TESTING_LOCKED_READYQUEUE
     ScopedLock<WorkerLock> sl(readyLock);
 #endif
     queue[f.getPriority()].push(f);
-    stats->queue.add();
+    countAdd();
   }
 
+#if TESTING_STEAL_HALF || TESTING_BATCH_RESUME
+  // chain linked via FredReadyLink, all freds with same priority
+  void enqueueBatch(Fred& first, Fred& last, size_t count) {
+    RASSERT(first.getPriority() < Fred::NumPriority, first.getPriority());
+#if TESTING_LOCKED_READYQUEUE
+    ScopedLock<WorkerLock> sl(readyLock);
+#endif
+    queue[first.getPriority()].push(first, last);
+    countAdd(count);
+  }
+#endif
+
+#if TESTING_WORKSTEALING_DEQUE
+  // must only be called by owner, falls back to inbox if deque is full
+  void enqueueLocal(Fred& f) {
+    if (f.getPriority() == Fred::DefaultPriority && deque.push(f)) countAdd();
+    else enqueue(f);
+  }
+#endif
+
   void reset(BaseProcessor& bp, _friend<EventScope>) {
     new (stats) FredStats::ReadyQueueStats(this, &bp);
   }
@@ -100,25 +252,102 @@ class BaseProcessor : public DoubleLink<BaseProcessor,2> {
 
   static const size_t HaltSpinMax =   64;
   static const size_t IdleSpinMax = 1024;
+#if TESTING_STEAL_HALF
+  static const size_t StealBatchMax =  32;
+#endif
+#if TESTING_RUN_NEXT
+  static const mword  RunNextGrace  = 8192;  // cycle counter ticks before slot can be stolen
+  static const size_t RunNextMax    =   16;  // consecutive dispatches before ready queue gets a turn
+  Fred* volatile runNext;                    // single-entry LIFO slot for local resumes
+  volatile mword runNextStamp;
+  size_t         runNextCount;
+
+  void runNextLength(ssize_t n) {           // slot occupant counts as queued
+#if TESTING_STEAL_HALF || TESTING_PLACEMENT_CHOICES
+    readyQueue.countOutside(n);
+#else
+    (void)n;
+#endif
+  }
+
+  Fred* stealRunNext() {
+    Fred* f = runNext;
+    if (!f || CycleCount() - runNextStamp < RunNextGrace) return nullptr;
+    if (!__atomic_compare_exchange_n(&runNext, &f, nullptr, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return nullptr;
+    runNextLength(-1);
+    return f;
+  }
+#endif
+#if TESTING_STEAL_TOPOLOGY
+  static const size_t StealLevels   =   4; // core, LLC, NUMA node, remote
+  static const size_t StealRefresh  =  64; // searches between victim grouping updates
+  size_t          cpu;                       // cpu hint, updated with victim grouping
+  size_t          stealSeed;                 // random start for victim search
+  BaseProcessor** stealVictims;              // other processors, grouped by distance level
+  size_t          stealBound[StealLevels+1]; // level boundaries in 'stealVictims'
+  size_t          stealCount;                // processor count at grouping
+  size_t          stealAge;                  // searches since grouping
+
+  size_t stealRandom() {                     // xorshift64
+    stealSeed ^= stealSeed << 13;
+    stealSeed ^= stealSeed >> 7;
+    stealSeed ^= stealSeed << 17;
+    return stealSeed;
+  }
+
+  void stealGroup(size_t count);
+#endif
 
   inline Fred*   searchAll();
   inline Fred*   searchLocal();
 #if TESTING_LOADBALANCING
   inline Fred*   searchSteal();
+  inline Fred*   trySteal(BaseProcessor& victim);
 #else
   Benaphore<>    readyCount;
 #endif
   HaltSemaphore  haltSem;
   Fred*          handoverFred;
+#if TESTING_LOCKFREE_PLACEMENT
+  BaseProcessor* placeCursor;  // owner-only round-robin cursor for placement
+#endif
+#if TESTING_PLACEMENT_CHOICES
+  volatile bool  idling;       // processor in idle loop, i.e., not running a fred
+#endif
 #if TESTING_WAKE_FRED_WORKER
   bool           halting = false;
 #endif
 
+  // RunNext = false: local resume bypasses runNext slot, so fred can be stolen right away
+  template<bool Resume = false, bool RunNext = Resume>
   void enqueueFred(Fred& f) {
     DBG::outl(DBG::Level::Scheduling, "Fred ", FmtHex(&f), " queueing on ", FmtHex(this));
+#if TESTING_RUN_NEXT || TESTING_WORKSTEALING_DEQUE
+    if (Resume && Context::TryCurrProcessor() == this) {
+      Fred* fp = &f;
+#if TESTING_RUN_NEXT
+      if (RunNext && f.getPriority() == Fred::DefaultPriority) {
+        runNextStamp = CycleCount();
+        fp = __atomic_exchange_n(&runNext, fp, __ATOMIC_SEQ_CST);
+        if (!fp) {                           // otherwise: previous fred moves to ready queue
+          runNextLength(1);
+          return;
+        }
+      }
+#endif
+#if TESTING_WORKSTEALING_DEQUE
+      readyQueue.enqueueLocal(*fp);
+#else
+      readyQueue.enqueue(*fp);
+#endif
+      return;
+    }
+#endif
     readyQueue.enqueue(f);
   }
 
+  template<bool RunNext>
+  inline void  enqueueReady(Fred& f, BaseProcessor& proc);
   inline Fred* scheduleBlocking();
   inline Fred* scheduleNonblocking();
   inline Fred& scheduleIdle();
@@ -133,11 +362,42 @@ public:
   FredStats::ProcessorStats* stats;
 
   BaseProcessor(Scheduler& c, const char* n = "Processor  ") : readyQueue(*this), haltSem(0), handoverFred(nullptr), scheduler(c), idleFred(nullptr) {
+#if TESTING_STEAL_TOPOLOGY
+    cpu = ~size_t(0);
+    stealSeed = uintptr_t(this) | 1;
+    stealVictims = nullptr;
+    stealCount = 0;
+    stealAge = 0;
+#endif
+#if TESTING_RUN_NEXT
+    runNext = nullptr;
+    runNextStamp = 0;
+    runNextCount = 0;
+#endif
+#if TESTING_LOCKFREE_PLACEMENT
+    placeCursor = this;
+#endif
+#if TESTING_PLACEMENT_CHOICES
+    idling = true;
+#endif
     stats = new FredStats::ProcessorStats(this, &c, n);
   }
 
   Scheduler& getScheduler() { return scheduler; }
 
+#if TESTING_PLACEMENT_CHOICES
+  // estimate: queued freds (including runNext) plus the one currently running
+  size_t getLoad() const { return readyQueue.getLength() + (idling ? 0 : 1); }
+#endif
+
+#if TESTING_LOCKFREE_PLACEMENT
+  // must only be called by owner
+  BaseProcessor& placeNext(_friend<Fred>) {
+    placeCursor = ProcessorRing::next(*placeCursor);
+    return *placeCursor;
+  }
+#endif
+
 #if TESTING_WAKE_FRED_WORKER
   bool isHalting(_friend<IdleManager>) { return halting; }
   void setHalting(bool h, _friend<IdleManager>) { halting = h; }
@@ -168,6 +428,13 @@ public:
 
   void enqueueYield(Fred& f, _friend<Fred>) { enqueueFred(f); }
   void enqueueResume(Fred& f, BaseProcessor&proc, _friend<Fred>);
+  void enqueueParent(Fred& f, _friend<Fred>);
+#if TESTING_BATCH_RESUME
+  void enqueueResumeBatch(Fred& first, Fred& last, size_t count, _friend<ResumeBatch>) {
+    DBG::outl(DBG::Level::Scheduling, "Fred ", FmtHex(&first), '-', FmtHex(&last), " queueing on ", FmtHex(this));
+    readyQueue.enqueueBatch(first, last, count);
+  }
+#endif
 
   void reset(Scheduler& c, _friend<EventScope> token, const char* n = "Processor  ") {
     new (stats) FredStats::ProcessorStats(this, &c, n);
@@ -712,6 +712,125 @@ public:
   }
 };
 
+// binary semaphore in a single word: posted flag or one waiting fred (lock-free),
+// additional or timed waiters are queued using a lock bit in the same word
+class ReadySemaphore {
+  static const uintptr_t Ready  = 1;
+  static const uintptr_t Queued = 2;
+  static const uintptr_t Locked = 4;
+  static const uintptr_t Flags  = Ready | Queued | Locked;
+
+  volatile uintptr_t state;         // flags | waiting Fred*
+  BlockingQueue bq;
+
+  struct StateLock {
+    volatile uintptr_t& state;
+    void acquire() {
+      for (;;) {
+        uintptr_t s = state;
+        if fastpath(!(s & Locked) && _CAS(&state, s, s | Locked, __ATOMIC_SEQ_CST)) return;
+        Pause();
+      }
+    }
+    void release() { __atomic_fetch_and(&state, ~Locked, __ATOMIC_SEQ_CST); }
+  };
+
+  template<typename... Args>
+  SemaphoreResult slowP(const Args&... args) {
+    StateLock lock = { state };
+    lock.acquire();
+    for (;;) {
+      uintptr_t s = state;
+      if (s & Ready) {
+        if (!_CAS(&state, s, s & ~Ready, __ATOMIC_SEQ_CST)) continue;
+        lock.release();
+        return SemaphoreWasOpen;
+      }
+      if (_CAS(&state, s, s | Queued, __ATOMIC_SEQ_CST)) break;
+    }
+    if (bq.block(lock, args...)) return SemaphoreSuccess;
+    ScopedLock<StateLock> sl(lock);
+    if (bq.empty()) __atomic_fetch_and(&state, ~Queued, __ATOMIC_SEQ_CST);
+    return SemaphoreTimeout;
+  }
+
+public:
+  explicit ReadySemaphore(ssize_t c = 0) : state(c ? Ready : 0) { RASSERT(c == 0 || c == 1, c); }
+  ~ReadySemaphore() { reset(); }
+  void reset(ssize_t c = 0) {
+    StateLock lock = { state };
+    lock.acquire();
+    RASSERT(!(state & ~(Ready|Locked)) && bq.empty(), FmtHex(state));
+    __atomic_store_n(&state, c ? Ready : 0, __ATOMIC_SEQ_CST); // also releases lock
+  }
+  ssize_t getValue() const { return (state & Ready) ? 1 : (state & ~(Ready|Locked)) ? -1 : 0; }
+
+  SemaphoreResult P() {
+    Fred* cf = Context::CurrFred();
+    RASSERT0(((uintptr_t)cf & Flags) == 0);
+    RuntimeDisablePreemption();
+    for (;;) {
+      uintptr_t s = state;
+      if (s == Ready) {
+        if (!_CAS(&state, s, uintptr_t(0), __ATOMIC_SEQ_CST)) continue;
+        RuntimeEnablePreemption();
+        return SemaphoreWasOpen;
+      }
+      if (s != 0) break;
+      if (_CAS(&state, s, (uintptr_t)cf, __ATOMIC_SEQ_CST)) {
+        Suspender::suspend<false>(*cf);
+        return SemaphoreSuccess;
+      }
+    }
+    RuntimeEnablePreemption();
+    return slowP(true);             // contended
+  }
+
+  SemaphoreResult P(const Time& timeout) { return slowP(timeout); }
+
+  SemaphoreResult tryP() {
+    for (uintptr_t s = state; s & Ready; s = state) {
+      if (_CAS(&state, s, s & ~Ready, __ATOMIC_SEQ_CST)) return SemaphoreWasOpen;
+    }
+    return SemaphoreTimeout;
+  }
+
+  // use condition/signal semantics
+  SemaphoreResult wait() {
+    __atomic_fetch_and(&state, ~Ready, __ATOMIC_SEQ_CST);
+    return P();
+  }
+
+  template<bool Enqueue = true>
+  Fred* V() {
+    for (;;) {
+      uintptr_t s = state;
+      if (s & ~Flags) {             // waiter in state word
+        if (!_CAS(&state, s, s & Flags, __ATOMIC_SEQ_CST)) continue;
+        Fred* next = (Fred*)(s & ~Flags);
+        if (Enqueue) next->resume();
+        return next;
+      }
+      if (s & Queued) {
+        StateLock lock = { state };
+        lock.acquire();
+        Fred* next = bq.template unblock<false>();
+        if (bq.empty()) __atomic_fetch_and(&state, ~Queued, __ATOMIC_SEQ_CST);
+        if (!next) {                // waiters timed out: post, timed-out waiter cleans up queue
+          __atomic_fetch_or(&state, Ready, __ATOMIC_SEQ_CST);
+          lock.release();
+          return nullptr;
+        }
+        lock.release();
+        if (Enqueue) next->resume();
+        return next;
+      }
+      if (s & Ready) return nullptr;
+      if (_CAS(&state, s, s | Ready, __ATOMIC_SEQ_CST)) return nullptr;
+    }
+  }
+};
+
 /****************************** Compound Types ******************************/
 
 template<typename Semaphore, bool Binary = false>
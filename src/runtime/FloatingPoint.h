@@ -35,6 +35,9 @@ public:
     asm volatile("ldmxcsr %0" :: "m"(csr) : "memory");
     asm volatile("fldcw   %0" :: "m"(cw) : "memory");
   }
+  // full MXCSR including exception status bits: each fibre observes only its own flags
+  bool operator==(const FloatingPointFlags& x) const { return csr == x.csr && cw == x.cw; }
+  bool operator!=(const FloatingPointFlags& x) const { return !(*this == x); }
 };
 
 class FloatingPointContext {
@@ -66,6 +69,8 @@ public:
   FloatingPointFlags(bool) {}
   void save() {}
   void restore() {}
+  bool operator==(const FloatingPointFlags&) const { return true; }
+  bool operator!=(const FloatingPointFlags&) const { return false; }
 };
 
 class FloatingPointContext; // not available for __aarch64__ yet
@@ -19,26 +19,58 @@
 #include "runtime-glue/RuntimeFred.h"
 
 Fred::Fred(BaseProcessor& proc)
-: stackPointer(0), processor(&proc), priority(DefaultPriority), affinity(DefaultAffinity), runState(Running) {
+: stackPointer(0), processor(&proc), priority(DefaultPriority), affinity(DefaultAffinity), placePending(false), runState(Running) {
+#if TESTING_LAZY_STACK
+  lazyStart[0] = nullptr;
+#endif
   processor->stats->create.count();
 }
 
-Fred::Fred(Scheduler& scheduler) : Fred(scheduler.placement(_friend<Fred>())) {}
+static inline BaseProcessor* localProcessor(Scheduler& scheduler) {
+  BaseProcessor* cproc = Context::TryCurrProcessor();
+  return (cproc && &cproc->getScheduler() == &scheduler) ? cproc : nullptr;
+}
+
+Fred::Fred(Scheduler& scheduler) : Fred(localProcessor(scheduler), scheduler) {}
+
+// on a worker of the target scheduler: defer placement until start, since
+// child-first start runs the new fred locally and must not advance placement
+Fred::Fred(BaseProcessor* local, Scheduler& scheduler)
+: Fred(local ? *local : scheduler.placement(_friend<Fred>())) {
+  placePending = local;
+}
+
+void Fred::placeInternal() {
+  processor = &processor->getScheduler().placement(_friend<Fred>());
+  placePending = false;
+}
+
+#if TESTING_LAZY_STACK
+void Fred::bindStack() {
+  RuntimeBindStack(*this, _friend<Fred>()); // sets initial stack pointer
+  stackPointer = stackInit(stackPointer, lazyStart[0], lazyStart[1], lazyStart[2], lazyStart[3]);
+  lazyStart[0] = nullptr;
+}
+#endif
 
 template<Fred::SwitchCode Code>
 inline void Fred::switchFred(Fred& nextFred) {
   // various checks
-  static_assert(Code == Idle || Code == Yield || Code == Resume || Code == Suspend || Code == Terminate, "Illegal SwitchCode");
+  static_assert(Code == Idle || Code == Yield || Code == Resume || Code == Direct || Code == Suspend || Code == Terminate, "Illegal SwitchCode");
   CHECK_PREEMPTION(0);
   RASSERT(this == Context::CurrFred() && this != &nextFred, FmtHex(this), ' ', FmtHex(Context::CurrFred()), ' ', FmtHex(&nextFred));
 
   // context switch
   DBG::outl(DBG::Level::Scheduling, "Fred switch <", char(Code), "> on ", FmtHex(&Context::CurrProcessor()),": ", FmtHex(this), " (to ", FmtHex(processor), ") -> ", FmtHex(&nextFred));
+#if TESTING_LAZY_STACK
+  if (nextFred.lazyStart[0]) nextFred.bindStack(); // first dispatch
+#endif
   RuntimePreFredSwitch(*this, nextFred, _friend<Fred>());
   switch (Code) {
     case Idle:      stackSwitch(this, postIdle,      &stackPointer, nextFred.stackPointer); break;
     case Yield:     stackSwitch(this, postYield,     &stackPointer, nextFred.stackPointer); break;
     case Resume:    stackSwitch(this, postResume,    &stackPointer, nextFred.stackPointer); break;
+    case Direct:    stackSwitch(this, postDirect,    &stackPointer, nextFred.stackPointer); break;
     case Suspend:   stackSwitch(this, postSuspend,   &stackPointer, nextFred.stackPointer); break;
     case Terminate: stackSwitch(this, postTerminate, &stackPointer, nextFred.stackPointer); break;
   }
@@ -63,6 +95,12 @@ void Fred::postResume(Fred* prevFred) {
   prevFred->resumeInternal();
 }
 
+// child-first start -> requeue parent, bypassing runNext slot
+void Fred::postDirect(Fred* prevFred) {
+  CHECK_PREEMPTION(0);
+  prevFred->processor->enqueueParent(*prevFred, _friend<Fred>());
+}
+
 // if resumption already triggered -> resume right away
 void Fred::postSuspend(Fred* prevFred) {
   CHECK_PREEMPTION(0);
@@ -94,6 +132,18 @@ void Fred::resumeInternal() {
   processor->enqueueResume(*this, *processor, _friend<Fred>());
 }
 
+void Fred::startDirectInternal() {
+  BaseProcessor* cproc = Context::TryCurrProcessor();
+  if (cproc && &cproc->getScheduler() == &processor->getScheduler()) {
+    placePending = false;      // no placement: runs here
+    processor = cproc;
+    Context::CurrFred()->yieldDirect(*this);
+  } else {                     // not on a worker of the target scheduler -> regular start
+    if (placePending) placeInternal();
+    resumeInternal();
+  }
+}
+
 void Fred::suspendInternal() {
   switchFred<Suspend>(Context::CurrProcessor().scheduleFull(_friend<Fred>()));
 }
@@ -112,6 +162,13 @@ inline void Fred::yieldResume(Fred& nextFred) {
   RuntimeEnablePreemption();
 }
 
+inline void Fred::yieldDirect(Fred& nextFred) {
+  CHECK_PREEMPTION(1);           // expect preemption still enabled
+  RuntimeDisablePreemption();
+  switchFred<Direct>(nextFred);  // yield and increase fredCounter
+  RuntimeEnablePreemption();
+}
+
 bool Fred::yield() {
   Fred* nextFred = Context::CurrProcessor().tryScheduleLocal(_friend<Fred>());
   if (nextFred) Context::CurrFred()->yieldTo(*nextFred);
@@ -25,6 +25,7 @@ class EventScope;
 class BaseProcessor;
 class IdleManager;
 class KernelProcessor;
+class ResumeBatch;
 class Scheduler;
 struct Suspender;
 
@@ -72,37 +73,49 @@ private:
   BaseProcessor* processor;    // next resumption on this processor
   Priority       priority;     // scheduling priority
   size_t         affinity;     // affinity to worker
+  bool           placePending; // placement deferred to start, see Fred(Scheduler&)
 
   enum RunState : size_t { Parked = 0, Running = 1, ResumedEarly = 2 };
   RunState volatile runState;    // 0 = parked, 1 = running, 2 = early resume
   ptr_t    volatile resumeInfo;
+#if TESTING_LAZY_STACK
+  ptr_t    lazyStart[4];         // entry function and arguments, until stack is bound
+#endif
 
   Fred(const Fred&) = delete;
   const Fred& operator=(const Fred&) = delete;
 
   // central fred switching routine
-  enum SwitchCode { Idle = 'I', Yield = 'Y', Resume = 'R', Suspend = 'S', Terminate = 'T' };
+  enum SwitchCode { Idle = 'I', Yield = 'Y', Resume = 'R', Direct = 'D', Suspend = 'S', Terminate = 'T' };
   template<SwitchCode> inline void switchFred(Fred& nextFred);
 
   // these routines are called immediately after the stack switch
   static void postIdle     (Fred* prevFred);
   static void postYield    (Fred* prevFred);
   static void postResume   (Fred* prevFred);
+  static void postDirect   (Fred* prevFred);
   static void postSuspend  (Fred* prevFred);
   static void postTerminate(Fred* prevFred);
 
   void resumeDirect();
   void resumeInternal();
+  void startDirectInternal();
+  void placeInternal();
+#if TESTING_LAZY_STACK
+  void bindStack();
+#endif
 
   // these routines must be called with 'this' being the current fred
   void suspendInternal();
   inline void yieldTo(Fred& nextFred);
   inline void yieldResume(Fred& nextFred);
+  inline void yieldDirect(Fred& nextFred);
 
 protected:
   // constructor/destructors can only be called by derived classes
   Fred(BaseProcessor& proc); // main constructor
   Fred(Scheduler&);          // uses delegation
+  Fred(BaseProcessor* local, Scheduler&);
   ~Fred() { RASSERT(runState == Running, FmtHex(this), runState); }
 
   void initStackPointer(vaddr sp) {
@@ -117,15 +130,30 @@ public:
 
   // set up fred stack without immediate start
   void setup(ptr_t func, ptr_t p1 = nullptr, ptr_t p2 = nullptr, ptr_t p3 = nullptr) {
+#if TESTING_LAZY_STACK
+    if (stackPointer == 0) { // no stack yet -> bound by switchFred() at first dispatch
+      lazyStart[0] = func; lazyStart[1] = p1; lazyStart[2] = p2; lazyStart[3] = p3;
+      return;
+    }
+#endif
     stackPointer = stackInit(stackPointer, func, p1, p2, p3);
   }
 
   // set up new fred and resume for concurrent execution
   void start(ptr_t func, ptr_t p1 = nullptr, ptr_t p2 = nullptr, ptr_t p3 = nullptr) {
     setup(func, p1, p2, p3);
+    if (placePending) placeInternal();
     resumeInternal();
   }
 
+  // set up new fred and switch to it immediately on the current processor (work-first)
+  // the caller's continuation goes to the local ready queue (not the runNext slot)
+  // and can be stolen from there
+  void startDirect(ptr_t func, ptr_t p1 = nullptr, ptr_t p2 = nullptr, ptr_t p3 = nullptr) {
+    setup(func, p1, p2, p3);
+    startDirectInternal();
+  }
+
   // context switching - static -> apply to Context::CurrFred()
   static bool yield();
   static bool yieldGlobal();
@@ -147,6 +175,9 @@ public:
     return resumeInfo;
   }
 
+  // NOTE: all wakeup paths (BlockingQueue, TimerQueue, pollers) resume a Fred and
+  // the scheduler dispatches via stack switch; stackless (C++20) coroutines would
+  // need a separate dispatch path, and the code base is built with -std=c++11.
   template<bool DirectSwitch = false>
   void resume() {
     size_t prev = __atomic_fetch_add(&runState, RunState(1), __ATOMIC_SEQ_CST);
@@ -158,6 +189,15 @@ public:
     }
   }
 
+#if TESTING_BATCH_RESUME
+  // same as resume(), but caller enqueues, if true is returned (Parked -> Running)
+  bool prepareResume(_friend<ResumeBatch>) {
+    size_t prev = __atomic_fetch_add(&runState, RunState(1), __ATOMIC_SEQ_CST);
+    RASSERT(prev == Parked || prev == Running, prev);
+    return prev == Parked;
+  }
+#endif
+
   void cancelEarlyResume(_friend<Suspender>) { runState = Running; }
 
   void prepareResumeRace(_friend<Suspender>) {
@@ -174,6 +214,11 @@ public:
     return __atomic_compare_exchange_n(&resumeInfo, &exp, ri, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
   }
 
+#if TESTING_STACK_RECLAIM
+  // saved stack pointer, 0 while running
+  vaddr getStackPointer() const { return __atomic_load_n(&stackPointer, __ATOMIC_RELAXED); }
+#endif
+
   Priority getPriority() const  { return priority; }
   Fred* setPriority(Priority p) { priority = p; return this; }
 
@@ -192,6 +237,13 @@ public:
     return *processor;
   }
 
+#if TESTING_BATCH_RESUME
+  BaseProcessor& getProcessor(_friend<ResumeBatch>) {
+    RASSERT0(processor);
+    return *processor;
+  }
+#endif
+
   // migration
   static BaseProcessor& migrate(BaseProcessor&);
   static BaseProcessor& migrate(Scheduler&);
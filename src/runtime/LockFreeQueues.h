@@ -20,6 +20,8 @@
 #include "runtime/SpinLocks.h"
 #include "runtime/ContainerLink.h"
 
+#include <sys/types.h> // ssize_t
+
 // https://doi.org/10.1145/103727.103729
 // the MCS queue can be used to construct an MCS lock or the Nemesis queue
 // next() might stall, if the queue contains one element and the producer of a second elements waits before setting 'prev->vnext'
@@ -182,6 +184,66 @@ public:
   }
 };
 
+// https://doi.org/10.1145/1073970.1073974 (Chase/Lev)
+// https://doi.org/10.1145/2442516.2442524 (C11 memory orders)
+// bounded variant: fixed-size buffer, push() fails when full -> caller provides overflow
+// push() and pop() must only be called by the owner, steal() by any thread
+// steal() gives up on contention (failed CAS) rather than retrying
+template<typename Node, size_t N>
+class DequeChaseLev {
+  static_assert((N & (N-1)) == 0, "DequeChaseLev size must be power of 2");
+  volatile ssize_t top;
+  volatile ssize_t bottom;
+  Node* volatile   buffer[N];
+
+public:
+  DequeChaseLev() : top(0), bottom(0) {}
+  bool empty() const {
+    return __atomic_load_n(&bottom, __ATOMIC_RELAXED) <= __atomic_load_n(&top, __ATOMIC_RELAXED);
+  }
+  size_t size() const {
+    ssize_t s = __atomic_load_n(&bottom, __ATOMIC_RELAXED) - __atomic_load_n(&top, __ATOMIC_RELAXED);
+    return s > 0 ? s : 0;
+  }
+
+  bool push(Node& elem) {
+    ssize_t b = __atomic_load_n(&bottom, __ATOMIC_RELAXED);
+    ssize_t t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+    if (b - t >= ssize_t(N)) return false;
+    __atomic_store_n(&buffer[b & (N-1)], &elem, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+    return true;
+  }
+
+  Node* pop() {
+    ssize_t b = __atomic_load_n(&bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ssize_t t = __atomic_load_n(&top, __ATOMIC_RELAXED);
+    if (t > b) {                               // empty
+      __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+      return nullptr;
+    }
+    Node* elem = __atomic_load_n(&buffer[b & (N-1)], __ATOMIC_RELAXED);
+    if (t == b) {                              // last element -> race with steal()
+      if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) elem = nullptr;
+      __atomic_store_n(&bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return elem;
+  }
+
+  Node* steal() {
+    ssize_t t = __atomic_load_n(&top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ssize_t b = __atomic_load_n(&bottom, __ATOMIC_ACQUIRE);
+    if (t >= b) return nullptr;
+    Node* elem = __atomic_load_n(&buffer[t & (N-1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return nullptr;
+    return elem;
+  }
+};
+
 template<typename T, size_t NUM=0, size_t CNT=1, typename LT=SingleLink<T,CNT>>
 using IntrusiveQueueNemesis = QueueNemesis<T,LT::template VNext<NUM>>;
 
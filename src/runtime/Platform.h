@@ -161,11 +161,21 @@ template <typename T> static inline constexpr size_t bitsize() { return sizeof(T
 
 static inline void Pause()       { asm volatile("pause"); }
 static inline void MemoryFence() { asm volatile("mfence" ::: "memory"); }
+static inline mword CycleCount() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return (mword(hi) << 32) | lo;
+}
 
 #elif defined(__aarch64__)
 
 static inline void Pause()       { asm volatile("yield"); }
 static inline void MemoryFence() { asm volatile("dmb sy" ::: "memory"); }
+static inline mword CycleCount() {
+  mword val;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(val));
+  return val;
+}
 
 #else
 #error unsupported architecture: only __x86_64__ or __aarch64__ supported at this time
@@ -191,13 +191,104 @@ public:
     ringCount -= 1;
   }
 
+  size_t getProcessorCount() const { return ringCount; }
+
+#if TESTING_PLACEMENT_CHOICES
+  // least-loaded of N processors, starting with round-robin candidate
+  static BaseProcessor& choose(BaseProcessor& proc) {
+    BaseProcessor* best = &proc;
+    size_t bestLoad = proc.getLoad();
+    BaseProcessor* p = &proc;
+    for (size_t i = 1; i < TESTING_PLACEMENT_CHOICES && bestLoad > 0; i += 1) {
+      p = ProcessorRing::next(*p);
+      if (p == &proc) break;
+      size_t load = p->getLoad();
+      if (load < bestLoad) {
+        best = p;
+        bestLoad = load;
+      }
+    }
+    return *best;
+  }
+#else
+  static BaseProcessor& choose(BaseProcessor& proc) { return proc; }
+#endif
+
+#if TESTING_LOCKFREE_PLACEMENT
+  // ring insert is traversal-safe: use worker's own cursor, if possible, else advance 'placeProc' atomically
+  // NOTE: removeProcessor() is not safe against concurrent placement in this mode
+  BaseProcessor& placement(_friend<Fred> fr) {
+    BaseProcessor* cp = Context::TryCurrProcessor();
+    if (cp && &cp->getScheduler() == this) return choose(cp->placeNext(fr));
+    BaseProcessor* p = __atomic_load_n(&placeProc, __ATOMIC_ACQUIRE);
+    RASSERT0(p);
+    for (;;) {
+      BaseProcessor* n = ProcessorRing::next(*p);
+      if (__atomic_compare_exchange_n(&placeProc, &p, n, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) return choose(*n);
+    }
+  }
+#else
   BaseProcessor& placement(_friend<Fred>) {
     // ring insert is traversal-safe, so could use separate 'placeLock' here
     ScopedLock<WorkerLock> sl(ringLock);
     RASSERT0(placeProc);
     placeProc = ProcessorRing::next(*placeProc);
-    return *placeProc;
+    return choose(*placeProc);
+  }
+#endif
+};
+
+#if TESTING_BATCH_RESUME
+// Collects resumed freds in per-processor/priority chains. flush() pushes
+// each chain with one queue operation and wakes at most one idle worker
+// per scheduler; a woken worker wakes the next one, if it finds work.
+class ResumeBatch {
+  static const size_t MaxChains = 8;
+  struct Chain {
+    BaseProcessor* proc;
+    Fred*          first;
+    Fred*          last;
+    size_t         count;
+  };
+  Chain  chain[MaxChains];
+  size_t chainCount;
+
+  ResumeBatch(const ResumeBatch&) = delete;            // no copy
+  ResumeBatch& operator=(const ResumeBatch&) = delete; // no assignment
+
+public:
+  ResumeBatch() : chainCount(0) {}
+  ~ResumeBatch() { flush(); }
+
+  void add(Fred& f) {
+    if (!f.prepareResume(_friend<ResumeBatch>())) return; // running -> resumed early
+    BaseProcessor* proc = &f.getProcessor(_friend<ResumeBatch>());
+    for (size_t c = 0; c < chainCount; c += 1) {
+      if (chain[c].proc == proc && chain[c].first->getPriority() == f.getPriority()) {
+        Fred::VNext<FredReadyLink>(*chain[c].last) = &f;
+        chain[c].last = &f;
+        chain[c].count += 1;
+        return;
+      }
+    }
+    if (chainCount == MaxChains) flush();
+    chain[chainCount] = { proc, &f, &f, 1 };
+    chainCount += 1;
+  }
+
+  void flush() {
+    for (size_t c = 0; c < chainCount; c += 1) {
+      chain[c].proc->enqueueResumeBatch(*chain[c].first, *chain[c].last, chain[c].count, _friend<ResumeBatch>());
+    }
+    for (size_t c = 0; c < chainCount; c += 1) {
+      Scheduler& s = chain[c].proc->getScheduler();
+      size_t p = 0;
+      while (p < c && &chain[p].proc->getScheduler() != &s) p += 1;
+      if (p == c) s.idleManager.unblock(chain[c].proc);
+    }
+    chainCount = 0;
   }
 };
+#endif
 
 #endif /* _Scheduler_h_ */
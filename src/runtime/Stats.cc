@@ -131,6 +131,12 @@ void PollerStats::print(ostream& os) const {
   if (totalPollerStats && this != totalPollerStats) totalPollerStats->aggregate(*this);
   Base::print(os);
   os << " regs: " << regs << " eventsB:" << eventsB << " eventsNB:" << eventsNB;
+#if TESTING_EVENTPOLL_BATCHCTL
+  os << " rearms:" << rearms;
+#endif
+#if TESTING_POLLER_ADAPTIVE
+  os << " grows: " << grows << " shrinks: " << shrinks;
+#endif
 }
 
 void IOUringStats::print(ostream& os) const {
@@ -163,6 +169,7 @@ void ProcessorStats::print(ostream& os) const {
   os << " C: "  << create;
   os << " S: "  << start;
   os << " D: "  << deq;
+  if (next)         os << " N: "  << next;
   if (handover)     os << " H: "  << handover;
   if (borrow)       os << " B: "  << borrow;
   if (steal)        os << " S: "  << steal;
@@ -170,6 +177,11 @@ void ProcessorStats::print(ostream& os) const {
   os << " W: " << wake;
 }
 
+void StackStats::print(ostream& os) const {
+  Base::print(os);
+  os << " M: " << maximum << " U:" << usage;
+}
+
 void ReadyQueueStats::print(ostream& os) const {
   if (totalReadyQueueStats && this != totalReadyQueueStats) totalReadyQueueStats->aggregate(*this);
   Base::print(os);
@@ -277,17 +277,26 @@ struct PollerStats : public Base {
   Counter regs;
   Distribution eventsB;
   Distribution eventsNB;
+  Distribution rearms;
+  Counter grows;
+  Counter shrinks;
   PollerStats(cptr_t o, cptr_t p, const char* n = "Poller") : Base(o, p, n, 1) {}
   void print(ostream& os) const;
   void aggregate(const PollerStats& x) {
     regs.aggregate(x.regs);
     eventsB.aggregate(x.eventsB);
     eventsNB.aggregate(x.eventsNB);
+    rearms.aggregate(x.rearms);
+    grows.aggregate(x.grows);
+    shrinks.aggregate(x.shrinks);
   }
   virtual void reset() {
     regs.reset();
     eventsB.reset();
     eventsNB.reset();
+    rearms.reset();
+    grows.reset();
+    shrinks.reset();
   }
 };
 
@@ -355,6 +364,7 @@ struct ProcessorStats : public Base {
   Counter create;
   Counter start;
   Counter deq;
+  Counter next;
   Counter handover;
   Counter borrow;
   Counter steal;
@@ -366,6 +376,7 @@ struct ProcessorStats : public Base {
     create.aggregate(x.create);
     start.aggregate(x.start);
     deq.aggregate(x.deq);
+    next.aggregate(x.next);
     handover.aggregate(x.handover);
     borrow.aggregate(x.borrow);
     steal.aggregate(x.steal);
@@ -376,6 +387,7 @@ struct ProcessorStats : public Base {
     create.reset();
     start.reset();
     deq.reset();
+    next.reset();
     handover.reset();
     borrow.reset();
     steal.reset();
@@ -384,6 +396,21 @@ struct ProcessorStats : public Base {
   }
 };
 
+struct StackStats : public Base {
+  Distribution usage;
+  size_t maximum;
+  StackStats(cptr_t o, cptr_t p, const char* n = "Stack      ") : Base(o, p, n, 3), maximum(0) {}
+  void print(ostream& os) const;
+  void count(size_t n) {
+    usage.count(n);
+    if (n > maximum) maximum = n;
+  }
+  virtual void reset() {
+    usage.reset();
+    maximum = 0;
+  }
+};
+
 struct ReadyQueueStats : public Base {
   Queue queue;
   ReadyQueueStats(cptr_t o, cptr_t p, const char* n = "ReadyQueue") : Base(o, p, n, 0) {}
@@ -405,6 +432,7 @@ struct ReadyQueueStats : public Base {
   0 IOUring
   1 Timer
   2 Cluster
+  3 Stack
   0  Poller
   1  IdleManager
   2  Processor